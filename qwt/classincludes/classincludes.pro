@@ -50,6 +50,8 @@ CLASSHEADERS = \
     QwtPickerTrackerMachine \
     QwtPixelMatrix \
     QwtPlainTextEngine \
+    QwtPlotProfile \
+    QwtPlotProfiler \
     QwtPoint3D \
     QwtPointPolar \
     QwtPowerTransform \
@@ -61,6 +63,7 @@ CLASSHEADERS = \
     QwtScaleDraw \
     QwtScaleEngine \
     QwtScaleMap \
+    QwtScratchPool \
     QwtSimpleCompassRose \
     QwtSplineBasis \
     QwtSpline \
@@ -70,9 +73,11 @@ CLASSHEADERS = \
     QwtSplineG1 \
     QwtSplineInterpolating \
     QwtSplineLocal \
+    QwtSplineLocalIncremental \
     QwtSplineParameter \
     QwtSplinePleasing \
     QwtSplinePolynomial \
+    QwtSpriteRenderer \
     QwtSymbol \
     QwtSystemClock \
     QwtText \
@@ -92,6 +97,7 @@ contains(QWT_CONFIG, QwtPlot) {
         QwtLegendData \
         QwtLegendLabel \
         QwtPointMapper \
+        QwtSpatialIndex \
         QwtMatrixRasterData \
         QwtOHLCSample \
         QwtPlot \
@@ -114,6 +120,7 @@ contains(QWT_CONFIG, QwtPlot) {
         QwtPlotPicker \
         QwtPlotRasterItem \
         QwtPlotRenderer \
+        QwtPlotScene \
         QwtPlotRescaler \
         QwtPlotScaleItem \
         QwtPlotSeriesItem \
@@ -130,6 +137,7 @@ contains(QWT_CONFIG, QwtPlot) {
         QwtSetSample \
         QwtSamplingThread \
         QwtSplineCurveFitter \
+        QwtStreamingCurveFitter \
         QwtWeedingCurveFitter \
         QwtIntervalSeriesData \
         QwtPoint3DSeriesData \
@@ -138,6 +146,7 @@ contains(QWT_CONFIG, QwtPlot) {
         QwtSyntheticPointData \
         QwtPointArrayData \
         QwtTradingChartData \
+        QwtHistogramData \
         QwtCPointerData
 }
 
@@ -9,9 +9,9 @@
 
 #include "qwt_clipper.h"
 #include "qwt_point_polar.h"
+#include "qwt_plot_profile.h"
+#include "qwt_scratch_pool.h"
 #include <qrect.h>
-#include <string.h>
-#include <stdlib.h>
 
 #if QT_VERSION < 0x040601
 #define qAtan(x) ::atan(x)
@@ -25,7 +25,8 @@ namespace QwtClip
     template <class Point, typename T> class TopEdge;
     template <class Point, typename T> class BottomEdge;
 
-    template <class Point> class PointBuffer;
+    template <class Polygon, class Point> class PolygonBuffer;
+    template <class Polygon, class Point, typename T> class Pipeline;
 }
 
 template <class Point, typename Value>
@@ -123,86 +124,241 @@ private:
     const Value d_y2;
 };
 
-template<class Point>
-class QwtClip::PointBuffer
+template <class Polygon, class Point>
+class QwtClip::PolygonBuffer
 {
 public:
-    explicit PointBuffer( int capacity = 0 ):
-        m_capacity( 0 ),
-        m_size( 0 ),
-        m_buffer( NULL )
+    /*
+      Collecting the clipped points directly in a polygon,
+      that is taken from QwtScratchPool. So there is no need
+      for copying them to the result.
+     */
+    explicit PolygonBuffer( int capacity ):
+        m_polygon( qwtScratchPolygon<Polygon>( qMax( capacity, 1 ) ) ),
+        m_size( 0 )
     {
-        if ( capacity > 0 )
-            reserve( capacity );
+        m_points = m_polygon.data();
     }
 
-    ~PointBuffer()
+    inline void add( const Point &point )
     {
-        if ( m_buffer )
-            ::free( m_buffer );
+        if ( m_size >= m_polygon.size() )
+        {
+            m_polygon.resize( 2 * m_polygon.size() );
+            m_points = m_polygon.data();
+        }
+
+        m_points[m_size++] = point;
     }
 
-    inline void setPoints( int numPoints, const Point *points )
+    inline Polygon polygon()
     {
-        reserve( numPoints );
-
-        m_size = numPoints;
-        ::memcpy( m_buffer, points, m_size * sizeof( Point ) );
+        m_polygon.resize( m_size );
+        return m_polygon;
     }
 
-    inline void reset() 
-    { 
-        m_size = 0; 
-    }
+private:
+    Polygon m_polygon;
+    Point *m_points;
+    int m_size;
+};
 
-    inline int size() const 
-    { 
-        return m_size; 
+template <class Polygon, class Point, typename T>
+class QwtClip::Pipeline
+{
+public:
+    /*
+      The 4 edges of Sutherland-Hodgman as a pipeline of stages:
+      each point is passed through all stages, before the next point
+      is processed. So the polygon needs to be iterated only once and
+      the clipped points are written into one buffer.
+     */
+    inline Pipeline( T x1, T x2, T y1, T y2,
+            bool closePolygon, PolygonBuffer<Polygon, Point> &points ):
+        d_left( x1, x2, y1, y2 ),
+        d_right( x1, x2, y1, y2 ),
+        d_top( x1, x2, y1, y2 ),
+        d_bottom( x1, x2, y1, y2 ),
+        d_closePolygon( closePolygon ),
+        d_points( points )
+    {
+        for ( int i = 0; i < 4; i++ )
+            d_stages[i].count = 0;
     }
 
-    inline Point *data() const 
-    { 
-        return m_buffer; 
+    inline void add( const Point &point )
+    {
+        push( 0, point );
     }
 
-    inline Point &operator[]( int i ) 
-    { 
-        return m_buffer[i]; 
+    void finish()
+    {
+        // the stages need to be finished in order, as finishing
+        // a stage might pass points to the following stages
+
+        finishStage( d_stages[0], d_left, 1 );
+        finishStage( d_stages[1], d_right, 2 );
+        finishStage( d_stages[2], d_top, 3 );
+        finishStage( d_stages[3], d_bottom, 4 );
     }
 
-    inline const Point &operator[]( int i ) const 
-    { 
-        return m_buffer[i]; 
+private:
+    class Stage
+    {
+    public:
+        int count;
+
+        Point first;
+        bool firstInside;
+
+        Point last;
+        bool lastInside;
+    };
+
+    inline void push( int stageIndex, const Point &point )
+    {
+        switch( stageIndex )
+        {
+            case 0:
+                clip( d_stages[0], d_left, point, 1 );
+                break;
+            case 1:
+                clip( d_stages[1], d_right, point, 2 );
+                break;
+            case 2:
+                clip( d_stages[2], d_top, point, 3 );
+                break;
+            case 3:
+                clip( d_stages[3], d_bottom, point, 4 );
+                break;
+            default:
+                d_points.add( point );
+        }
     }
 
-    inline void add( const Point &point )
+    template <class Edge>
+    inline void clip( Stage &stage, const Edge &edge,
+        const Point &point, int next )
     {
-        if ( m_capacity <= m_size )
-            reserve( m_size + 1 );
+        const bool isInside = edge.isInside( point );
+
+        if ( stage.count == 0 )
+        {
+            stage.first = point;
+            stage.firstInside = isInside;
+
+            // for closed polygons the first point is
+            // processed with the closing line in finishStage()
 
-        m_buffer[m_size++] = point;
+            if ( isInside && !d_closePolygon )
+                push( next, point );
+        }
+        else
+        {
+            if ( isInside )
+            {
+                if ( !stage.lastInside )
+                    push( next, edge.intersection( point, stage.last ) );
+
+                push( next, point );
+            }
+            else if ( stage.lastInside )
+            {
+                push( next, edge.intersection( point, stage.last ) );
+            }
+        }
+
+        stage.last = point;
+        stage.lastInside = isInside;
+        stage.count++;
     }
 
-private:
-    inline void reserve( int size )
+    template <class Edge>
+    inline void finishStage( Stage &stage, const Edge &edge, int next )
     {
-        if ( m_capacity == 0 )
-            m_capacity = 1;
+        if ( stage.count == 1 )
+        {
+            // a single point is never clipped
+            if ( d_closePolygon || !stage.firstInside )
+                push( next, stage.first );
+        }
+        else if ( stage.count > 1 && d_closePolygon )
+        {
+            // the line from the last to the first point
 
-        while ( m_capacity < size )
-            m_capacity *= 2;
+            if ( stage.firstInside )
+            {
+                if ( !stage.lastInside )
+                    push( next, edge.intersection( stage.first, stage.last ) );
 
-        m_buffer = static_cast<Point *>( 
-            ::realloc( m_buffer, m_capacity * sizeof( Point ) ) );
+                push( next, stage.first );
+            }
+            else if ( stage.lastInside )
+            {
+                push( next, edge.intersection( stage.first, stage.last ) );
+            }
+        }
     }
 
-    int m_capacity;
-    int m_size;
-    Point *m_buffer;
+    const LeftEdge<Point, T> d_left;
+    const RightEdge<Point, T> d_right;
+    const TopEdge<Point, T> d_top;
+    const BottomEdge<Point, T> d_bottom;
+
+    const bool d_closePolygon;
+
+    Stage d_stages[4];
+    PolygonBuffer<Polygon, Point> &d_points;
 };
 
 using namespace QwtClip;
 
+namespace
+{
+    enum Location
+    {
+        Inside,
+        Outside,
+        Intersecting
+    };
+}
+
+template <class Point, typename T>
+static Location qwtLocation( const Point *points, int numPoints,
+    T x1, T x2, T y1, T y2 )
+{
+    // a single pass, that can be vectorized by the compiler
+
+    bool isInside = true;
+
+    T minX = points[0].x();
+    T maxX = minX;
+    T minY = points[0].y();
+    T maxY = minY;
+
+    for ( int i = 0; i < numPoints; i++ )
+    {
+        const T x = points[i].x();
+        const T y = points[i].y();
+
+        isInside = isInside & ( x >= x1 ) & ( x <= x2 )
+            & ( y >= y1 ) & ( y <= y2 );
+
+        minX = qMin( minX, x );
+        maxX = qMax( maxX, x );
+        minY = qMin( minY, y );
+        maxY = qMax( maxY, y );
+    }
+
+    if ( isInside )
+        return Inside;
+
+    if ( maxX < x1 || minX > x2 || maxY < y1 || minY > y2 )
+        return Outside;
+
+    return Intersecting;
+}
+
 template <class Polygon, class Rect, class Point, typename T>
 class QwtPolygonClipper
 {
@@ -214,91 +370,99 @@ public:
 
     Polygon clipPolygon( const Polygon &polygon, bool closePolygon ) const
     {
-#if 0
-        if ( d_clipRect.contains( polygon.boundingRect() ) )
+        const int numPoints = polygon.size();
+        if ( numPoints < 2 )
             return polygon;
-#endif
 
-        PointBuffer<Point> points1;
-        PointBuffer<Point> points2( qMin( 256, polygon.size() ) );
+        const T x1 = d_clipRect.x();
+        const T x2 = d_clipRect.x() + d_clipRect.width();
+        const T y1 = d_clipRect.y();
+        const T y2 = d_clipRect.y() + d_clipRect.height();
 
-        points1.setPoints( polygon.size(), polygon.data() );
+        const Point *points = polygon.constData();
 
-        clipEdge< LeftEdge<Point, T> >( closePolygon, points1, points2 );
-        clipEdge< RightEdge<Point, T> >( closePolygon, points2, points1 );
-        clipEdge< TopEdge<Point, T> >( closePolygon, points1, points2 );
-        clipEdge< BottomEdge<Point, T> >( closePolygon, points2, points1 );
+        switch( qwtLocation( points, numPoints, x1, x2, y1, y2 ) )
+        {
+            case Inside:
+            {
+                // implicitly shared, no need to copy the points
+                return polygon;
+            }
+            case Outside:
+            {
+                return Polygon();
+            }
+            default:
+                break;
+        }
+
+        PolygonBuffer<Polygon, Point> clippedPoints( numPoints + 8 );
+
+        Pipeline<Polygon, Point, T> pipeline( x1, x2, y1, y2,
+            closePolygon, clippedPoints );
 
-        Polygon p;
-        p.resize( points1.size() );
-        ::memcpy( p.data(), points1.data(), points1.size() * sizeof( Point ) );
+        for ( int i = 0; i < numPoints; i++ )
+            pipeline.add( points[i] );
 
-        return p;
+        pipeline.finish();
+
+        return clippedPoints.polygon();
     }
 
 private:
-    template <class Edge>
-    inline void clipEdge( bool closePolygon,
-        PointBuffer<Point> &points, PointBuffer<Point> &clippedPoints ) const
-    {
-        clippedPoints.reset();
+    const Rect d_clipRect;
+};
 
-        if ( points.size() < 2 )
-        {
-            if ( points.size() == 1 )
-                clippedPoints.add( points[0] );
-            return;
-        }
+static inline bool qwtClipLine( const QRectF &rect,
+    const QPointF &p1, const QPointF &p2, double &t1, double &t2 )
+{
+    // Liang-Barsky: the parameters of the line inside of the rectangle
+
+    const double dx = p2.x() - p1.x();
+    const double dy = p2.y() - p1.y();
+
+    const double p[4] = { -dx, dx, -dy, dy };
+    const double q[4] =
+    {
+        p1.x() - rect.left(), rect.right() - p1.x(),
+        p1.y() - rect.top(), rect.bottom() - p1.y()
+    };
 
-        const Edge edge( d_clipRect.x(), d_clipRect.x() + d_clipRect.width(),
-            d_clipRect.y(), d_clipRect.y() + d_clipRect.height() );
+    t1 = 0.0;
+    t2 = 1.0;
 
-        int lastPos, start;
-        if ( closePolygon )
+    for ( int i = 0; i < 4; i++ )
+    {
+        if ( p[i] == 0.0 )
         {
-            start = 0;
-            lastPos = points.size() - 1;
+            if ( q[i] < 0.0 )
+                return false;
         }
         else
         {
-            start = 1;
-            lastPos = 0;
-
-            if ( edge.isInside( points[0] ) )
-                clippedPoints.add( points[0] );
-        }
-
-        const uint nPoints = points.size();
-        for ( uint i = start; i < nPoints; i++ )
-        {
-            const Point &p1 = points[i];
-            const Point &p2 = points[lastPos];
+            const double t = q[i] / p[i];
 
-            if ( edge.isInside( p1 ) )
+            if ( p[i] < 0.0 )
             {
-                if ( edge.isInside( p2 ) )
-                {
-                    clippedPoints.add( p1 );
-                }
-                else
-                {
-                    clippedPoints.add( edge.intersection( p1, p2 ) );
-                    clippedPoints.add( p1 );
-                }
+                if ( t > t2 )
+                    return false;
+
+                if ( t > t1 )
+                    t1 = t;
             }
             else
             {
-                if ( edge.isInside( p2 ) )
-                {
-                    clippedPoints.add( edge.intersection( p1, p2 ) );
-                }
+                if ( t < t1 )
+                    return false;
+
+                if ( t < t2 )
+                    t2 = t;
             }
-            lastPos = i;
         }
     }
 
-    const Rect d_clipRect;
-};
+    return true;
+}
 
 class QwtCircleClipper
 {
@@ -438,6 +602,11 @@ QList<QPointF> QwtCircleClipper::cuttingPoints(
 /*!
    Sutherland-Hodgman polygon clipping
 
+   Polygons, that are completely inside or outside of the
+   clip rectangle, are detected in one pass, without clipping.
+   Otherwise all edges of the rectangle are clipped in the same pass.
+   For closed polygons the first point of the result might differ.
+
    \param clipRect Clip rectangle
    \param polygon Polygon
    \param closePolygon True, when the polygon is closed
@@ -447,6 +616,8 @@ QList<QPointF> QwtCircleClipper::cuttingPoints(
 QPolygon QwtClipper::clipPolygon(
     const QRectF &clipRect, const QPolygon &polygon, bool closePolygon )
 {
+    QwtPlotProfiler::Timer timer( QwtPlotProfiler::Clipping );
+
     const int minX = qCeil( clipRect.left() );
     const int maxX = qFloor( clipRect.right() );
     const int minY = qCeil( clipRect.top() );
@@ -460,6 +631,11 @@ QPolygon QwtClipper::clipPolygon(
 /*!
    Sutherland-Hodgman polygon clipping
 
+   Polygons, that are completely inside or outside of the
+   clip rectangle, are detected in one pass, without clipping.
+   Otherwise all edges of the rectangle are clipped in the same pass.
+   For closed polygons the first point of the result might differ.
+
    \param clipRect Clip rectangle
    \param polygon Polygon
    \param closePolygon True, when the polygon is closed
@@ -469,6 +645,8 @@ QPolygon QwtClipper::clipPolygon(
 QPolygon QwtClipper::clipPolygon(
     const QRect &clipRect, const QPolygon &polygon, bool closePolygon )
 {
+    QwtPlotProfiler::Timer timer( QwtPlotProfiler::Clipping );
+
     QwtPolygonClipper<QPolygon, QRect, QPoint, int> clipper( clipRect );
     return clipper.clipPolygon( polygon, closePolygon );
 }
@@ -476,6 +654,11 @@ QPolygon QwtClipper::clipPolygon(
 /*!
    Sutherland-Hodgman polygon clipping
 
+   Polygons, that are completely inside or outside of the
+   clip rectangle, are detected in one pass, without clipping.
+   Otherwise all edges of the rectangle are clipped in the same pass.
+   For closed polygons the first point of the result might differ.
+
    \param clipRect Clip rectangle
    \param polygon Polygon
    \param closePolygon True, when the polygon is closed
@@ -485,10 +668,106 @@ QPolygon QwtClipper::clipPolygon(
 QPolygonF QwtClipper::clipPolygonF(
     const QRectF &clipRect, const QPolygonF &polygon, bool closePolygon )
 {
+    QwtPlotProfiler::Timer timer( QwtPlotProfiler::Clipping );
+
     QwtPolygonClipper<QPolygonF, QRectF, QPointF, double> clipper( clipRect );
     return clipper.clipPolygon( polygon, closePolygon );
 }
 
+/*!
+   Clip a polyline into the parts inside of a rectangle
+
+   In opposite to clipPolygonF() the polyline is not connected along
+   the border of the rectangle, when it leaves and enters the rectangle
+   again. Instead it is split into the parts inside of the rectangle.
+
+   \param clipRect Clip rectangle
+   \param polyline Polyline
+
+   \return Parts of the polyline inside of the clip rectangle
+*/
+QVector<QPolygonF> QwtClipper::clipPolylineF(
+    const QRectF &clipRect, const QPolygonF &polyline )
+{
+    QwtPlotProfiler::Timer timer( QwtPlotProfiler::Clipping );
+
+    QVector<QPolygonF> parts;
+
+    const int numPoints = polyline.size();
+    if ( numPoints == 0 )
+        return parts;
+
+    const QPointF *points = polyline.constData();
+
+    if ( numPoints == 1 )
+    {
+        if ( clipRect.contains( points[0] ) )
+            parts += polyline;
+
+        return parts;
+    }
+
+    switch( qwtLocation( points, numPoints, clipRect.left(),
+        clipRect.right(), clipRect.top(), clipRect.bottom() ) )
+    {
+        case Inside:
+        {
+            parts += polyline;
+            return parts;
+        }
+        case Outside:
+        {
+            return parts;
+        }
+        default:
+            break;
+    }
+
+    QPolygonF part;
+
+    for ( int i = 1; i < numPoints; i++ )
+    {
+        const QPointF &p1 = points[i - 1];
+        const QPointF &p2 = points[i];
+
+        double t1, t2;
+        if ( !qwtClipLine( clipRect, p1, p2, t1, t2 ) )
+            continue;
+
+        if ( t1 > 0.0 || part.isEmpty() )
+        {
+            // entering the rectangle
+
+            if ( !part.isEmpty() )
+            {
+                parts += part;
+                part.clear();
+            }
+
+            part += ( t1 > 0.0 ) ? p1 + t1 * ( p2 - p1 ) : p1;
+        }
+
+        if ( t2 < 1.0 )
+        {
+            // leaving the rectangle
+
+            part += p1 + t2 * ( p2 - p1 );
+
+            parts += part;
+            part.clear();
+        }
+        else
+        {
+            part += p2;
+        }
+    }
+
+    if ( !part.isEmpty() )
+        parts += part;
+
+    return parts;
+}
+
 /*!
    Circle clipping
 
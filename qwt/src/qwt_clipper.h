@@ -33,6 +33,9 @@ public:
     static QPolygonF clipPolygonF( const QRectF &, 
         const QPolygonF &, bool closePolygon = false );
 
+    static QVector<QPolygonF> clipPolylineF(
+        const QRectF &, const QPolygonF & );
+
     static QVector<QwtInterval> clipCircle(
         const QRectF &, const QPointF &, double radius );
 };
@@ -12,6 +12,7 @@
 #include "qwt_painter.h"
 #include <qpainter.h>
 #include <qpalette.h>
+#include <qvector.h>
 
 static void qwtDrawBox( QPainter *p, const QRectF &rect,
     const QPalette &pal, double lw )
@@ -108,6 +109,19 @@ static void qwtDrawPanel( QPainter *painter, const QRectF &rect,
     painter->fillRect( rect.adjusted( lw, lw, -lw + 1, -lw + 1 ), pal.window() );
 }
 
+static inline QwtInterval qwtColumnInterval( const QwtColumnRect &column )
+{
+    // the interval, where the column is aligned to its neighbours
+
+    if ( column.direction == QwtColumnRect::LeftToRight
+        || column.direction == QwtColumnRect::RightToLeft )
+    {
+        return column.vInterval.normalized();
+    }
+
+    return column.hInterval.normalized();
+}
+
 class QwtColumnSymbol::PrivateData
 {
 public:
@@ -253,6 +267,173 @@ void QwtColumnSymbol::draw( QPainter *painter,
     painter->restore();
 }
 
+/*!
+  \brief Draw the symbol for a series of columns
+
+  Neighboured columns, that are narrower than a pixel and in the same
+  pixel, are merged into one column.
+
+  In Box style without a frame, or with a Plain frame and an opaque
+  window brush, all columns are painted by filling all rectangles
+  at once. Otherwise draw() is called for each column.
+
+  \param painter Painter
+  \param columns Array of directed rectangles
+  \param numColumns Number of columns
+
+  \note As the frames are painted below all windows, the result differs
+        from calling draw() for each column, when columns are overlapping.
+  \sa draw(), mergedColumns()
+*/
+void QwtColumnSymbol::drawColumns( QPainter *painter,
+    const QwtColumnRect *columns, int numColumns ) const
+{
+    if ( numColumns <= 0 || d_data->style == NoStyle )
+        return;
+
+    const QVector<QwtColumnRect> merged =
+        mergedColumns( columns, numColumns );
+
+    const FrameStyle frameStyle = d_data->frameStyle;
+    const QBrush windowBrush = d_data->palette.window();
+
+    bool doBatch = false;
+    if ( d_data->style == QwtColumnSymbol::Box )
+    {
+        doBatch = ( frameStyle == NoFrame ) ||
+            ( frameStyle == Plain && windowBrush.isOpaque() );
+    }
+
+    if ( !doBatch )
+    {
+        for ( int i = 0; i < merged.size(); i++ )
+            draw( painter, merged[i] );
+
+        return;
+    }
+
+    const bool doAlign = QwtPainter::roundingAlignment( painter );
+    const double lineWidth = ( frameStyle == Plain ) ? d_data->lineWidth : 0.0;
+
+    QVector<QRectF> frameRects;
+    QVector<QRectF> windowRects;
+
+    if ( frameStyle == Plain && lineWidth > 0.0 )
+        frameRects.reserve( merged.size() );
+
+    windowRects.reserve( merged.size() );
+
+    for ( int i = 0; i < merged.size(); i++ )
+    {
+        QRectF r = merged[i].toRect();
+        if ( doAlign )
+        {
+            r.setLeft( qRound( r.left() ) );
+            r.setRight( qRound( r.right() ) );
+            r.setTop( qRound( r.top() ) );
+            r.setBottom( qRound( r.bottom() ) );
+        }
+
+        if ( frameStyle == NoFrame )
+        {
+            if ( r.isValid() )
+                windowRects += r;
+
+            continue;
+        }
+
+        // the same geometry as drawBox() for a Plain frame
+
+        double lw = lineWidth;
+        if ( lw > 0.0 )
+        {
+            frameRects += r.adjusted( 0, 0, 1, 1 );
+
+            if ( r.width() == 0.0 || r.height() == 0.0 )
+                continue;
+
+            lw = qMin( lw, r.height() / 2.0 - 1.0 );
+            lw = qMin( lw, r.width() / 2.0 - 1.0 );
+        }
+
+        const QRectF windowRect = r.adjusted( lw, lw, -lw + 1, -lw + 1 );
+        if ( windowRect.isValid() )
+            windowRects += windowRect;
+    }
+
+    painter->save();
+
+    painter->setPen( Qt::NoPen );
+
+    if ( !frameRects.isEmpty() )
+    {
+        painter->setBrush( d_data->palette.dark() );
+        QwtPainter::drawRects( painter,
+            frameRects.constData(), frameRects.size() );
+    }
+
+    if ( !windowRects.isEmpty() )
+    {
+        painter->setBrush( windowBrush );
+        QwtPainter::drawRects( painter,
+            windowRects.constData(), windowRects.size() );
+    }
+
+    painter->restore();
+}
+
+/*!
+  \brief Merge columns, that can't be distinguished
+
+  Neighboured columns with the same direction, that are narrower than
+  a pixel and in the same pixel, are merged into one column covering
+  all of them.
+
+  \param columns Array of directed rectangles
+  \param numColumns Number of columns
+
+  \return Merged columns
+  \sa drawColumns()
+*/
+QVector<QwtColumnRect> QwtColumnSymbol::mergedColumns(
+    const QwtColumnRect *columns, int numColumns )
+{
+    QVector<QwtColumnRect> merged;
+    merged.reserve( numColumns );
+
+    for ( int i = 0; i < numColumns; i++ )
+    {
+        const QwtColumnRect &column = columns[i];
+
+        if ( !merged.isEmpty() )
+        {
+            QwtColumnRect &last = merged.last();
+
+            if ( last.direction == column.direction )
+            {
+                const QwtInterval iv1 = qwtColumnInterval( last );
+                const QwtInterval iv2 = qwtColumnInterval( column );
+
+                if ( iv1.width() < 1.0 && iv2.width() < 1.0 &&
+                    qFloor( iv1.minValue() ) == qFloor( iv2.minValue() ) )
+                {
+                    last.hInterval = last.hInterval.normalized()
+                        | column.hInterval.normalized();
+
+                    last.vInterval = last.vInterval.normalized()
+                        | column.vInterval.normalized();
+
+                    continue;
+                }
+            }
+        }
+
+        merged += column;
+    }
+
+    return merged;
+}
+
 /*!
   Draw the symbol when it is in Box style.
 
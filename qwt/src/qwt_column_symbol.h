@@ -15,6 +15,7 @@
 #include <qpen.h>
 #include <qsize.h>
 #include <qrect.h>
+#include <qvector.h>
 
 class QPainter;
 class QPalette;
@@ -150,6 +151,12 @@ public:
 
     virtual void draw( QPainter *, const QwtColumnRect & ) const;
 
+    void drawColumns( QPainter *,
+        const QwtColumnRect *, int numColumns ) const;
+
+    static QVector<QwtColumnRect> mergedColumns(
+        const QwtColumnRect *, int numColumns );
+
 protected:
     void drawBox( QPainter *, const QwtColumnRect & ) const;
 
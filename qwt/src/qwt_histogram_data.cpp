@@ -0,0 +1,679 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_histogram_data.h"
+#include "qwt_math.h"
+#include <qvector.h>
+#include <qthread.h>
+#include <qatomic.h>
+#include <qfuture.h>
+#include <qtconcurrentrun.h>
+
+// batches with less values are counted without threads
+static const int qwtMinChunkSize = 100000;
+
+static inline int qwtBinIndex( double value,
+    double minValue, double invBinWidth, int numBins )
+{
+    // the maximum of the range is counted to the last bin
+    const int index = int( ( value - minValue ) * invBinWidth );
+    return qMin( index, numBins - 1 );
+}
+
+static QVector<double> qwtCountValues( const double *values, int numValues,
+    double minValue, double maxValue, int numBins )
+{
+    QVector<double> bins( numBins, 0.0 );
+    double *b = bins.data();
+
+    const double invBinWidth = numBins / ( maxValue - minValue );
+
+    double numOutliers = 0.0;
+    for ( int i = 0; i < numValues; i++ )
+    {
+        const double v = values[i];
+
+        // also NaN values are failing this condition
+        if ( v >= minValue && v <= maxValue )
+            b[ qwtBinIndex( v, minValue, invBinWidth, numBins ) ] += 1.0;
+        else if ( qIsFinite( v ) )
+            numOutliers += 1.0;
+    }
+
+    // the outliers are appended behind the bins
+    bins += numOutliers;
+
+    return bins;
+}
+
+class QwtHistogramData::PrivateData
+{
+public:
+    PrivateData():
+        numBins( 0 ),
+        mode( QwtHistogramData::FixedBins ),
+        totalCount( 0.0 ),
+        outlierCount( 0.0 ),
+        maxBinValue( 0.0 ),
+        sequence( 0 )
+    {
+    }
+
+    /*
+      The bins are published like with a sequence lock: the sequence
+      is odd, while the producer modifies the bins. Readers never block
+      the producer - they repeat reading, when the bins have been
+      modified in between.
+     */
+    inline void beginWrite()
+    {
+        sequence.fetchAndAddOrdered( 1 );
+    }
+
+    inline void endWrite()
+    {
+        sequence.fetchAndAddOrdered( 1 );
+    }
+
+    inline int beginRead()
+    {
+        int seq = sequence.fetchAndAddOrdered( 0 );
+        while ( seq & 1 )
+        {
+            QThread::yieldCurrentThread();
+            seq = sequence.fetchAndAddOrdered( 0 );
+        }
+
+        return seq;
+    }
+
+    inline bool endRead( int seq )
+    {
+        return sequence.fetchAndAddOrdered( 0 ) == seq;
+    }
+
+    QwtInterval range;
+    int numBins;
+    QwtHistogramData::BinningMode mode;
+
+    QVector<double> bins;
+
+    double totalCount;
+    double outlierCount;
+    double maxBinValue;
+
+    QAtomicInt sequence;
+};
+
+/*!
+  \brief Constructor
+
+  \param range Range of the bins
+  \param numBins Number of bins
+  \param mode Binning mode
+
+  \sa setBinning(), setBinningMode()
+ */
+QwtHistogramData::QwtHistogramData( const QwtInterval &range,
+    int numBins, BinningMode mode )
+{
+    d_data = new PrivateData;
+    d_data->mode = mode;
+
+    setBinning( range, numBins );
+}
+
+//! Destructor
+QwtHistogramData::~QwtHistogramData()
+{
+    delete d_data;
+}
+
+/*!
+  \brief Define the bins
+
+  All counted values are discarded.
+
+  \param range Range of the bins
+  \param numBins Number of equidistant bins. In AdaptiveBins mode
+                 odd numbers are increased by one, so that pairs
+                 of bins can be merged.
+
+  \sa range(), binCount(), reset()
+ */
+void QwtHistogramData::setBinning( const QwtInterval &range, int numBins )
+{
+    numBins = qMax( numBins, 1 );
+    if ( d_data->mode == AdaptiveBins && ( numBins % 2 ) )
+        numBins++;
+
+    d_data->beginWrite();
+
+    d_data->range = range.normalized();
+    d_data->range.setBorderFlags( QwtInterval::IncludeBorders );
+
+    if ( !( d_data->range.width() > 0.0 && qIsFinite( d_data->range.width() ) ) )
+    {
+        // no bins for an empty or infinite range
+        d_data->range = QwtInterval();
+    }
+
+    d_data->numBins = numBins;
+
+    clearBins();
+
+    d_data->endWrite();
+}
+
+/*!
+  \return Range of the bins
+  \sa setBinning()
+ */
+QwtInterval QwtHistogramData::range() const
+{
+    return d_data->range;
+}
+
+/*!
+  \return Number of bins
+  \sa setBinning()
+ */
+int QwtHistogramData::binCount() const
+{
+    return d_data->numBins;
+}
+
+/*!
+  \brief Set the binning mode
+
+  Switching to AdaptiveBins with an odd number of bins
+  redefines the bins and discards all counted values.
+
+  \param mode Binning mode
+  \sa binningMode()
+ */
+void QwtHistogramData::setBinningMode( BinningMode mode )
+{
+    if ( mode == d_data->mode )
+        return;
+
+    d_data->mode = mode;
+
+    if ( mode == AdaptiveBins && ( d_data->numBins % 2 ) )
+        setBinning( d_data->range, d_data->numBins );
+}
+
+/*!
+  \return Binning mode
+  \sa setBinningMode()
+ */
+QwtHistogramData::BinningMode QwtHistogramData::binningMode() const
+{
+    return d_data->mode;
+}
+
+/*!
+  \brief Count a value
+
+  Values, that are not finite ( NaN, inf ), are ignored.
+
+  \param value Value
+  \sa addValues()
+ */
+void QwtHistogramData::addValue( double value )
+{
+    if ( !qIsFinite( value ) )
+        return;
+
+    d_data->beginWrite();
+
+    if ( d_data->mode == AdaptiveBins )
+        extendRange( value, value );
+
+    d_data->totalCount += 1.0;
+
+    const QwtInterval &range = d_data->range;
+    if ( !range.isValid() || !range.contains( value ) )
+    {
+        d_data->outlierCount += 1.0;
+    }
+    else
+    {
+        const double invBinWidth = d_data->numBins / range.width();
+
+        double &binValue = d_data->bins[ qwtBinIndex( value,
+            range.minValue(), invBinWidth, d_data->numBins ) ];
+
+        binValue += 1.0;
+        if ( binValue > d_data->maxBinValue )
+        {
+            d_data->maxBinValue = binValue;
+            updateBoundingRect();
+        }
+    }
+
+    d_data->endWrite();
+}
+
+/*!
+  \brief Count a batch of values
+
+  Large batches are split into chunks, that are counted
+  by concurrent threads. Values, that are not finite ( NaN, inf ),
+  are ignored.
+
+  \param values Array of values
+  \param numValues Number of values
+
+  \sa addValue()
+ */
+void QwtHistogramData::addValues( const double *values, int numValues )
+{
+    if ( values == NULL || numValues <= 0 )
+        return;
+
+    if ( d_data->mode == AdaptiveBins )
+    {
+        double minValue = 0.0;
+        double maxValue = 0.0;
+        bool hasValues = false;
+
+        for ( int i = 0; i < numValues; i++ )
+        {
+            const double v = values[i];
+            if ( !qIsFinite( v ) )
+                continue;
+
+            if ( hasValues )
+            {
+                minValue = qMin( minValue, v );
+                maxValue = qMax( maxValue, v );
+            }
+            else
+            {
+                minValue = maxValue = v;
+                hasValues = true;
+            }
+        }
+
+        if ( !hasValues )
+            return;
+
+        d_data->beginWrite();
+        extendRange( minValue, maxValue );
+        d_data->endWrite();
+    }
+
+    const QwtInterval &range = d_data->range;
+
+    if ( !range.isValid() )
+    {
+        double numOutliers = 0.0;
+        for ( int i = 0; i < numValues; i++ )
+        {
+            if ( qIsFinite( values[i] ) )
+                numOutliers += 1.0;
+        }
+
+        d_data->beginWrite();
+
+        d_data->totalCount += numOutliers;
+        d_data->outlierCount += numOutliers;
+
+        d_data->endWrite();
+
+        return;
+    }
+
+    const int numBins = d_data->numBins;
+    const double minValue = range.minValue();
+    const double maxValue = range.maxValue();
+
+    QVector< QVector<double> > chunks;
+
+    int numThreads = 1;
+
+#if !defined(QT_NO_QFUTURE)
+    if ( numValues >= 2 * qwtMinChunkSize )
+    {
+        numThreads = QThread::idealThreadCount();
+        if ( numThreads <= 0 )
+            numThreads = 1;
+
+        numThreads = qMin( numThreads, numValues / qwtMinChunkSize );
+    }
+#endif
+
+    if ( numThreads > 1 )
+    {
+#if !defined(QT_NO_QFUTURE)
+        const int chunkSize = numValues / numThreads;
+
+        QList< QFuture< QVector<double> > > futures;
+        for ( int i = 0; i < numThreads; i++ )
+        {
+            const int from = i * chunkSize;
+            const int n = ( i == numThreads - 1 )
+                ? numValues - from : chunkSize;
+
+            futures += QtConcurrent::run( &qwtCountValues,
+                values + from, n, minValue, maxValue, numBins );
+        }
+
+        for ( int i = 0; i < futures.size(); i++ )
+            chunks += futures[i].result();
+#endif
+    }
+    else
+    {
+        chunks += qwtCountValues( values, numValues,
+            minValue, maxValue, numBins );
+    }
+
+    // the values have been counted without modifying the bins,
+    // now they are merged
+
+    d_data->beginWrite();
+
+    double *b = d_data->bins.data();
+
+    for ( int i = 0; i < chunks.size(); i++ )
+    {
+        const double *c = chunks[i].constData();
+
+        for ( int j = 0; j < numBins; j++ )
+        {
+            b[j] += c[j];
+            d_data->totalCount += c[j];
+        }
+
+        d_data->outlierCount += c[numBins];
+        d_data->totalCount += c[numBins];
+    }
+
+    double maxBinValue = d_data->maxBinValue;
+    for ( int j = 0; j < numBins; j++ )
+        maxBinValue = qMax( maxBinValue, b[j] );
+
+    if ( maxBinValue > d_data->maxBinValue )
+    {
+        d_data->maxBinValue = maxBinValue;
+        updateBoundingRect();
+    }
+
+    d_data->endWrite();
+}
+
+/*!
+  \brief Count a batch of values
+
+  \param values Values
+  \sa addValue()
+ */
+void QwtHistogramData::addValues( const QVector<double> &values )
+{
+    addValues( values.constData(), values.size() );
+}
+
+/*!
+  \brief Discard all counted values
+
+  The bins are kept.
+  \sa setBinning()
+ */
+void QwtHistogramData::reset()
+{
+    d_data->beginWrite();
+    clearBins();
+    d_data->endWrite();
+}
+
+/*!
+  \return Number of values counted in a bin
+  \param index Index of the bin
+ */
+double QwtHistogramData::binValue( int index ) const
+{
+    if ( index < 0 || index >= d_data->numBins )
+        return 0.0;
+
+    double value;
+
+    int seq;
+    do
+    {
+        seq = d_data->beginRead();
+        value = d_data->bins.constData()[index];
+    }
+    while ( !d_data->endRead( seq ) );
+
+    return value;
+}
+
+/*!
+  \return Number of all values, that have been added - including
+          the outliers, but without values, that are not finite
+  \sa outlierCount()
+ */
+double QwtHistogramData::totalCount() const
+{
+    double count;
+
+    int seq;
+    do
+    {
+        seq = d_data->beginRead();
+        count = d_data->totalCount;
+    }
+    while ( !d_data->endRead( seq ) );
+
+    return count;
+}
+
+/*!
+  \return Number of values, that have been outside of the range
+  \sa totalCount(), FixedBins
+ */
+double QwtHistogramData::outlierCount() const
+{
+    double count;
+
+    int seq;
+    do
+    {
+        seq = d_data->beginRead();
+        count = d_data->outlierCount;
+    }
+    while ( !d_data->endRead( seq ) );
+
+    return count;
+}
+
+/*!
+  \return Number of bins, or 0 when the range is invalid
+ */
+size_t QwtHistogramData::size() const
+{
+    bool isValid;
+
+    int seq;
+    do
+    {
+        seq = d_data->beginRead();
+        isValid = d_data->range.isValid();
+    }
+    while ( !d_data->endRead( seq ) );
+
+    return isValid ? d_data->numBins : 0;
+}
+
+/*!
+  \return Interval and number of values of a bin
+  \param index Index of the bin
+ */
+QwtIntervalSample QwtHistogramData::sample( size_t index ) const
+{
+    const int numBins = d_data->numBins;
+    const int i = static_cast<int>( index );
+
+    QwtInterval range;
+    double value;
+
+    int seq;
+    do
+    {
+        seq = d_data->beginRead();
+
+        range = d_data->range;
+        value = d_data->bins.constData()[i];
+    }
+    while ( !d_data->endRead( seq ) );
+
+    const double binWidth = range.width() / numBins;
+
+    const double x1 = range.minValue() + i * binWidth;
+    const double x2 = ( i == numBins - 1 )
+        ? range.maxValue() : range.minValue() + ( i + 1 ) * binWidth;
+
+    QwtInterval interval( x1, x2 );
+    if ( i < numBins - 1 )
+        interval.setBorderFlags( QwtInterval::ExcludeMaximum );
+
+    return QwtIntervalSample( value, interval );
+}
+
+/*!
+  \return Bounding rectangle of the bins
+
+  The rectangle is maintained, when values are counted and
+  doesn't need to iterate over the bins.
+ */
+QRectF QwtHistogramData::boundingRect() const
+{
+    QRectF rect;
+
+    int seq;
+    do
+    {
+        seq = d_data->beginRead();
+        rect = d_boundingRect;
+    }
+    while ( !d_data->endRead( seq ) );
+
+    return rect;
+}
+
+/*!
+  Double the range, until it contains an interval
+
+  \param minValue Minimum of the interval
+  \param maxValue Maximum of the interval
+ */
+void QwtHistogramData::extendRange( double minValue, double maxValue )
+{
+    QwtInterval &range = d_data->range;
+
+    if ( !range.isValid() )
+    {
+        double width = maxValue - minValue;
+        if ( width <= 0.0 )
+            width = qMax( qAbs( minValue ), 1.0 );
+
+        if ( !qIsFinite( minValue + width ) )
+        {
+            // the range stays invalid, all values are outliers
+            return;
+        }
+
+        range = QwtInterval( minValue, minValue + width );
+        updateBoundingRect();
+
+        return;
+    }
+
+    if ( range.contains( minValue ) && range.contains( maxValue ) )
+        return;
+
+    const int numBins = d_data->numBins;
+    const int half = numBins / 2;
+
+    double *b = d_data->bins.data();
+
+    while ( minValue < range.minValue() || maxValue > range.maxValue() )
+    {
+        const double width = range.width();
+
+        if ( !qIsFinite( range.minValue() - width )
+            || !qIsFinite( range.maxValue() + width ) )
+        {
+            // the values beyond are counted as outliers
+            break;
+        }
+
+        if ( minValue < range.minValue() )
+        {
+            // the old bins become the upper half
+            for ( int i = numBins - 1; i >= half; i-- )
+            {
+                const int j = 2 * i - numBins;
+                b[i] = b[j] + b[j + 1];
+            }
+
+            for ( int i = 0; i < half; i++ )
+                b[i] = 0.0;
+
+            range.setMinValue( range.minValue() - width );
+        }
+        else
+        {
+            // the old bins become the lower half
+            for ( int i = 0; i < half; i++ )
+                b[i] = b[2 * i] + b[2 * i + 1];
+
+            for ( int i = half; i < numBins; i++ )
+                b[i] = 0.0;
+
+            range.setMaxValue( range.maxValue() + width );
+        }
+    }
+
+    double maxBinValue = 0.0;
+    for ( int i = 0; i < numBins; i++ )
+        maxBinValue = qMax( maxBinValue, b[i] );
+
+    d_data->maxBinValue = maxBinValue;
+
+    updateBoundingRect();
+}
+
+void QwtHistogramData::clearBins()
+{
+    d_data->bins.fill( 0.0, d_data->numBins );
+
+    d_data->totalCount = 0.0;
+    d_data->outlierCount = 0.0;
+    d_data->maxBinValue = 0.0;
+
+    updateBoundingRect();
+}
+
+void QwtHistogramData::updateBoundingRect()
+{
+    const QwtInterval &range = d_data->range;
+
+    if ( range.isValid() )
+    {
+        d_boundingRect = QRectF( range.minValue(), 0.0,
+            range.width(), d_data->maxBinValue );
+    }
+    else
+    {
+        d_boundingRect = QRectF( 0.0, 0.0, -1.0, -1.0 );
+    }
+}
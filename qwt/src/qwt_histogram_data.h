@@ -0,0 +1,117 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_HISTOGRAM_DATA_H
+#define QWT_HISTOGRAM_DATA_H 1
+
+#include "qwt_global.h"
+#include "qwt_series_data.h"
+
+/*!
+  \brief Series of histogram bins, that are accumulated from raw values
+
+  QwtHistogramData counts values into equidistant bins. Values can be
+  added at any time without copying the bins, so that a QwtPlotHistogram
+  displaying the data only needs to be replotted.
+
+  The bounding rectangle is updated with each value and
+  never needs to iterate over the bins.
+
+  \code
+    QwtHistogramData *data = new QwtHistogramData(
+        QwtInterval( 0.0, 100.0 ), 10000 );
+
+    QwtPlotHistogram *histogram = new QwtPlotHistogram();
+    histogram->setSamples( data );
+
+    void Acquisition::append( const QVector<double> &values )
+    {
+        data->addValues( values );
+        histogram->dataChanged();
+    }
+  \endcode
+
+  Large batches of values are counted by concurrent threads
+  into partial bins, that are merged afterwards.
+
+  \note Values can be added by one thread, while another thread is painting
+        the histogram. The bins are published without locks: reading a bin
+        or the bounding rectangle is repeated, when it has been modified
+        at the same time. As each sample is read on its own, a histogram
+        painted during adding values might show bins of different states.
+        setBinning() and setBinningMode() must not be called concurrently.
+
+  \sa QwtPlotHistogram, BinningMode
+ */
+class QWT_EXPORT QwtHistogramData:
+    public QwtSeriesData<QwtIntervalSample>
+{
+public:
+    /*!
+      \brief Mode, how to handle values outside of the range of the bins
+      \sa setBinningMode()
+     */
+    enum BinningMode
+    {
+        /*!
+          Values outside of the range are not counted,
+          but added to the outliers.
+
+          \sa outlierCount()
+         */
+        FixedBins,
+
+        /*!
+          The range is doubled, until the value is inside. The number of bins
+          is kept by merging pairs of neighboured bins.
+          An invalid range is initialized from the first values.
+         */
+        AdaptiveBins
+    };
+
+    explicit QwtHistogramData( const QwtInterval &range = QwtInterval(),
+        int numBins = 100, BinningMode = FixedBins );
+
+    virtual ~QwtHistogramData();
+
+    void setBinning( const QwtInterval &range, int numBins );
+
+    QwtInterval range() const;
+    int binCount() const;
+
+    void setBinningMode( BinningMode );
+    BinningMode binningMode() const;
+
+    void addValue( double );
+    void addValues( const double *values, int numValues );
+    void addValues( const QVector<double> & );
+
+    void reset();
+
+    double binValue( int index ) const;
+
+    double totalCount() const;
+    double outlierCount() const;
+
+    virtual size_t size() const;
+    virtual QwtIntervalSample sample( size_t index ) const;
+    virtual QRectF boundingRect() const;
+
+private:
+    Q_DISABLE_COPY(QwtHistogramData)
+
+    void extendRange( double minValue, double maxValue );
+    void clearBins();
+    void updateBoundingRect();
+
+    class PrivateData;
+    PrivateData *d_data;
+};
+
+#endif
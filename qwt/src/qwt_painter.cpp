@@ -362,6 +362,24 @@ void QwtPainter::drawRect( QPainter *painter, const QRectF &rect )
     painter->drawRect( r );
 }
 
+//! Wrapper for QPainter::drawRects()
+void QwtPainter::drawRects( QPainter *painter,
+    const QRectF *rects, int rectCount )
+{
+    QRectF clipRect;
+    const bool deviceClipping = qwtIsClippingNeeded( painter, clipRect );
+
+    if ( deviceClipping )
+    {
+        for ( int i = 0; i < rectCount; i++ )
+            drawRect( painter, rects[i] );
+
+        return;
+    }
+
+    painter->drawRects( rects, rectCount );
+}
+
 //! Wrapper for QPainter::fillRect()
 void QwtPainter::fillRect( QPainter *painter,
     const QRectF &rect, const QBrush &brush )
@@ -541,6 +559,24 @@ void QwtPainter::drawLine( QPainter *painter,
     painter->drawLine( p1, p2 );
 }
 
+//! Wrapper for QPainter::drawLines()
+void QwtPainter::drawLines( QPainter *painter,
+    const QPointF *pointPairs, int lineCount )
+{
+    QRectF clipRect;
+    const bool deviceClipping = qwtIsClippingNeeded( painter, clipRect );
+
+    if ( deviceClipping )
+    {
+        for ( int i = 0; i < lineCount; i++ )
+            drawLine( painter, pointPairs[2 * i], pointPairs[2 * i + 1] );
+
+        return;
+    }
+
+    painter->drawLines( pointPairs, lineCount );
+}
+
 //! Wrapper for QPainter::drawPolygon()
 void QwtPainter::drawPolygon( QPainter *painter, const QPolygonF &polygon )
 {
@@ -560,12 +596,22 @@ void QwtPainter::drawPolyline( QPainter *painter, const QPolygonF &polygon )
     QRectF clipRect;
     const bool deviceClipping = qwtIsClippingNeeded( painter, clipRect );
 
-    QPolygonF cpa = polygon;
     if ( deviceClipping )
-        cpa = QwtClipper::clipPolygonF( clipRect, cpa );
+    {
+        const QVector<QPolygonF> parts =
+            QwtClipper::clipPolylineF( clipRect, polygon );
 
-    qwtDrawPolyline<QPointF>( painter,
-        cpa.constData(), cpa.size(), d_polylineSplitting );
+        for ( int i = 0; i < parts.size(); i++ )
+        {
+            qwtDrawPolyline<QPointF>( painter, parts[i].constData(),
+                parts[i].size(), d_polylineSplitting );
+        }
+    }
+    else
+    {
+        qwtDrawPolyline<QPointF>( painter,
+            polygon.constData(), polygon.size(), d_polylineSplitting );
+    }
 }
 
 //! Wrapper for QPainter::drawPolyline()
@@ -580,9 +626,14 @@ void QwtPainter::drawPolyline( QPainter *painter,
         QPolygonF polygon( pointCount );
         ::memcpy( polygon.data(), points, pointCount * sizeof( QPointF ) );
 
-        polygon = QwtClipper::clipPolygonF( clipRect, polygon );
-        qwtDrawPolyline<QPointF>( painter,
-            polygon.constData(), polygon.size(), d_polylineSplitting );
+        const QVector<QPolygonF> parts =
+            QwtClipper::clipPolylineF( clipRect, polygon );
+
+        for ( int i = 0; i < parts.size(); i++ )
+        {
+            qwtDrawPolyline<QPointF>( painter, parts[i].constData(),
+                parts[i].size(), d_polylineSplitting );
+        }
     }
     else
     {
@@ -60,6 +60,7 @@ public:
 
     static void drawRect( QPainter *, double x, double y, double w, double h );
     static void drawRect( QPainter *, const QRectF &rect );
+    static void drawRects( QPainter *, const QRectF *rects, int rectCount );
     static void fillRect( QPainter *, const QRectF &, const QBrush & );
 
     static void drawEllipse( QPainter *, const QRectF & );
@@ -68,6 +69,7 @@ public:
     static void drawLine( QPainter *, double x1, double y1, double x2, double y2 );
     static void drawLine( QPainter *, const QPointF &p1, const QPointF &p2 );
     static void drawLine( QPainter *, const QLineF & );
+    static void drawLines( QPainter *, const QPointF *pointPairs, int lineCount );
 
     static void drawPolygon( QPainter *, const QPolygonF & );
     static void drawPolyline( QPainter *, const QPolygonF & );
@@ -16,6 +16,7 @@
 #include "qwt_legend.h"
 #include "qwt_legend_data.h"
 #include "qwt_plot_canvas.h"
+#include "qwt_system_clock.h"
 #include <qmath.h>
 #include <qpainter.h>
 #include <qpointer.h>
@@ -101,6 +102,11 @@ public:
     QwtPlotLayout *layout;
 
     bool autoReplot;
+
+    bool profiling;
+    bool profilingItems;
+    QwtPlotProfile profile;
+    QwtPlotProfile lastProfile;
 };
 
 /*!
@@ -145,6 +151,8 @@ void QwtPlot::initPlot( const QwtText &title )
 
     d_data->layout = new QwtPlotLayout;
     d_data->autoReplot = false;
+    d_data->profiling = false;
+    d_data->profilingItems = false;
 
     // title
     d_data->titleLabel = new QwtTextLabel( this );
@@ -548,7 +556,19 @@ void QwtPlot::replot()
     bool doAutoReplot = autoReplot();
     setAutoReplot( false );
 
-    updateAxes();
+    if ( d_data->profiling )
+    {
+        QwtSystemClock clock;
+        clock.start();
+
+        updateAxes();
+
+        d_data->profile.updateAxesTime += clock.elapsed();
+    }
+    else
+    {
+        updateAxes();
+    }
 
     /*
       Maybe the layout needs to be updated, because of changed
@@ -577,6 +597,10 @@ void QwtPlot::replot()
 */
 void QwtPlot::updateLayout()
 {
+    QwtSystemClock clock;
+    if ( d_data->profiling )
+        clock.start();
+
     d_data->layout->activate( this, contentsRect() );
 
     QRect titleRect = d_data->layout->titleRect().toRect();
@@ -650,6 +674,9 @@ void QwtPlot::updateLayout()
     }
 
     d_data->canvas->setGeometry( canvasRect );
+
+    if ( d_data->profiling )
+        d_data->profile.layoutTime += clock.elapsed();
 }
 
 /*!
@@ -741,7 +768,26 @@ void QwtPlot::drawCanvas( QPainter *painter )
     for ( int axisId = 0; axisId < axisCnt; axisId++ )
         maps[axisId] = canvasMap( axisId );
 
-    drawItems( painter, d_data->canvas->contentsRect(), maps );
+    if ( d_data->profiling )
+    {
+        QwtSystemClock clock;
+        clock.start();
+
+        d_data->profilingItems = true;
+        drawItems( painter, d_data->canvas->contentsRect(), maps );
+        d_data->profilingItems = false;
+
+        d_data->profile.drawTime = clock.elapsed();
+
+        d_data->lastProfile = d_data->profile;
+        d_data->profile.reset();
+
+        Q_EMIT profileAvailable( d_data->lastProfile );
+    }
+    else
+    {
+        drawItems( painter, d_data->canvas->contentsRect(), maps );
+    }
 }
 
 /*!
@@ -774,15 +820,83 @@ void QwtPlot::drawItems( QPainter *painter, const QRectF &canvasRect,
             painter->setRenderHint( QPainter::HighQualityAntialiasing,
                 item->testRenderHint( QwtPlotItem::RenderAntialiased ) );
 
-            item->draw( painter,
-                maps[item->xAxis()], maps[item->yAxis()],
-                canvasRect );
+            if ( d_data->profilingItems )
+            {
+                QwtPlotProfile::ItemRecord record;
+                record.item = item;
+                record.rtti = item->rtti();
+                record.title = item->title().text();
+
+                QwtPlotProfile::ItemRecord *oldRecord =
+                    QwtPlotProfiler::setActiveRecord( &record );
+
+                QwtSystemClock clock;
+                clock.start();
+
+                item->draw( painter,
+                    maps[item->xAxis()], maps[item->yAxis()],
+                    canvasRect );
+
+                record.drawTime = clock.elapsed();
+
+                QwtPlotProfiler::setActiveRecord( oldRecord );
+                d_data->profile.items += record;
+            }
+            else
+            {
+                item->draw( painter,
+                    maps[item->xAxis()], maps[item->yAxis()],
+                    canvasRect );
+            }
 
             painter->restore();
         }
     }
 }
 
+/*!
+  \brief En/Disable the instrumentation of the replot cycle
+
+  When profiling is enabled the time spent in updateAxes(),
+  updateLayout() and the draw() method of each plot item is measured.
+  The time of an item is broken down into the mapping, clipping
+  and image rendering phases.
+
+  The results are available from lastProfile() and are emitted
+  by profileAvailable(), whenever the canvas has been painted.
+
+  Profiling is disabled by default.
+
+  \param on On/Off
+  \sa isProfilingEnabled(), lastProfile(), QwtPlotProfile
+ */
+void QwtPlot::setProfilingEnabled( bool on )
+{
+    if ( on != d_data->profiling )
+    {
+        d_data->profiling = on;
+        d_data->profile.reset();
+    }
+}
+
+/*!
+  \return true, when the replot cycle is instrumented
+  \sa setProfilingEnabled()
+ */
+bool QwtPlot::isProfilingEnabled() const
+{
+    return d_data->profiling;
+}
+
+/*!
+  \return Timings and counters of the last painted canvas
+  \sa setProfilingEnabled(), profileAvailable()
+ */
+QwtPlotProfile QwtPlot::lastProfile() const
+{
+    return d_data->lastProfile;
+}
+
 /*!
   \param axisId Axis
   \return Map for the axis on the canvas. With this map pixel coordinates can
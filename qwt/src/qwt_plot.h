@@ -15,6 +15,7 @@
 #include "qwt_plot_dict.h"
 #include "qwt_scale_map.h"
 #include "qwt_interval.h"
+#include "qwt_plot_profile.h"
 #include <qframe.h>
 #include <qlist.h>
 #include <qvariant.h>
@@ -257,6 +258,13 @@ public:
     virtual QVariant itemToInfo( QwtPlotItem * ) const;
     virtual QwtPlotItem *infoToItem( const QVariant & ) const;
 
+    // Profiling
+
+    void setProfilingEnabled( bool on );
+    bool isProfilingEnabled() const;
+
+    QwtPlotProfile lastProfile() const;
+
 Q_SIGNALS:
     /*!
       A signal indicating, that an item has been attached/detached
@@ -279,6 +287,16 @@ Q_SIGNALS:
     void legendDataChanged( const QVariant &itemInfo, 
         const QList<QwtLegendData> &data );
 
+    /*!
+      A signal, that is emitted, when the canvas has been painted
+      and profiling is enabled.
+
+      \param profile Timings and counters of the replot
+
+      \sa setProfilingEnabled(), lastProfile()
+     */
+    void profileAvailable( const QwtPlotProfile &profile );
+
 public Q_SLOTS:
     virtual void replot();
     void autoRefresh();
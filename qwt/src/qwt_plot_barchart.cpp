@@ -12,13 +12,15 @@
 #include "qwt_column_symbol.h"
 #include "qwt_painter.h"
 #include <qpainter.h>
+#include <qvector.h>
 
 class QwtPlotBarChart::PrivateData
 {
 public:
     PrivateData():
         symbol( NULL ),
-        legendMode( QwtPlotBarChart::LegendChartTitle )
+        legendMode( QwtPlotBarChart::LegendChartTitle ),
+        paintAttributes( 0 )
     {
     }
  
@@ -29,6 +31,8 @@ public:
 
     QwtColumnSymbol *symbol;
     QwtPlotBarChart::LegendMode legendMode;
+
+    QwtPlotBarChart::PaintAttributes paintAttributes;
 };
 
 /*!
@@ -69,6 +73,32 @@ int QwtPlotBarChart::rtti() const
     return QwtPlotItem::Rtti_PlotBarChart;
 }
 
+/*!
+  Specify an attribute how to draw the bar chart
+
+  \param attribute Paint attribute
+  \param on On/Off
+  \sa testPaintAttribute()
+*/
+void QwtPlotBarChart::setPaintAttribute(
+    PaintAttribute attribute, bool on )
+{
+    if ( on )
+        d_data->paintAttributes |= attribute;
+    else
+        d_data->paintAttributes &= ~attribute;
+}
+
+/*!
+    \return True, when attribute is enabled
+    \sa PaintAttribute, setPaintAttribute()
+*/
+bool QwtPlotBarChart::testPaintAttribute(
+    PaintAttribute attribute ) const
+{
+    return ( d_data->paintAttributes & attribute );
+}
+
 /*!
   Initialize data with an array of points
 
@@ -232,6 +262,34 @@ void QwtPlotBarChart::drawSeries( QPainter *painter,
     const QRectF br = data()->boundingRect();
     const QwtInterval interval( br.left(), br.right() );
 
+    if ( d_data->paintAttributes & BatchColumns )
+    {
+        QVector<QwtColumnRect> columns;
+        columns.reserve( to - from + 1 );
+
+        for ( int i = from; i <= to; i++ )
+        {
+            columns += columnRect( xMap, yMap,
+                canvasRect, interval, sample( i ) );
+        }
+
+        if ( d_data->symbol )
+        {
+            d_data->symbol->drawColumns( painter,
+                columns.constData(), columns.size() );
+        }
+        else
+        {
+            // we build a temporary default symbol
+            QwtColumnSymbol sym( QwtColumnSymbol::Box );
+            sym.setLineWidth( 1 );
+            sym.setFrameStyle( QwtColumnSymbol::Plain );
+            sym.drawColumns( painter, columns.constData(), columns.size() );
+        }
+
+        return;
+    }
+
     painter->save();
 
     for ( int i = from; i <= to; i++ )
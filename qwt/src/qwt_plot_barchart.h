@@ -67,6 +67,26 @@ public:
         LegendBarTitles
     };
 
+    /*!
+        Attributes to modify the drawing algorithm.
+        \sa setPaintAttribute(), testPaintAttribute()
+    */
+    enum PaintAttribute
+    {
+        /*!
+          All bars are painted at once by QwtColumnSymbol::drawColumns()
+          using the symbol() or a default symbol. Bars narrower than
+          a pixel are merged.
+
+          specialSymbol(), drawSample() and drawBar() are not called,
+          when this attribute is enabled.
+         */
+        BatchColumns = 0x01
+    };
+
+    //! Paint attributes
+    typedef QFlags<PaintAttribute> PaintAttributes;
+
     explicit QwtPlotBarChart( const QString &title = QString::null );
     explicit QwtPlotBarChart( const QwtText &title );
 
@@ -74,6 +94,9 @@ public:
 
     virtual int rtti() const;
 
+    void setPaintAttribute( PaintAttribute, bool on = true );
+    bool testPaintAttribute( PaintAttribute ) const;
+
     void setSamples( const QVector<QPointF> & );
     void setSamples( const QVector<double> & );
     void setSamples( QwtSeriesData<QPointF> *series );
@@ -120,4 +143,6 @@ private:
     PrivateData *d_data;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS( QwtPlotBarChart::PaintAttributes )
+
 #endif
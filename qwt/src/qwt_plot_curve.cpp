@@ -8,6 +8,7 @@
  *****************************************************************************/
 
 #include "qwt_plot_curve.h"
+#include "qwt_spatial_index.h"
 #include "qwt_point_data.h"
 #include "qwt_math.h"
 #include "qwt_clipper.h"
@@ -17,7 +18,11 @@
 #include "qwt_spline_curve_fitter.h"
 #include "qwt_symbol.h"
 #include "qwt_point_mapper.h"
+#include "qwt_plot_profile.h"
+#include "qwt_scratch_pool.h"
+#include <string.h>
 #include <qpainter.h>
+#include <qpainterpath.h>
 #include <qpixmap.h>
 #include <qalgorithms.h>
 #include <qmath.h>
@@ -38,6 +43,18 @@ static inline QRectF qwtIntersectedClipRect( const QRectF &rect, QPainter *paint
     return clipRect;
 }
 
+static inline void qwtClipPolyline(
+    const QRectF &clipRect, QPolygonF &polyline )
+{
+    const QPolygonF clipped = QwtClipper::clipPolygonF(
+        clipRect, polyline, false );
+
+    // the buffer of the unclipped points can be reused
+    QwtScratchPool::release( polyline );
+
+    polyline = clipped;
+}
+
 static void qwtUpdateLegendIconSize( QwtPlotCurve *curve )
 {
     if ( curve->symbol() && 
@@ -75,6 +92,139 @@ static int qwtVerifyRange( int size, int &i1, int &i2 )
     return ( i2 - i1 + 1 );
 }
 
+static QPolygonF qwtTransformPolygon( const QwtScaleMap &xMap,
+    const QwtScaleMap &yMap, const QPolygonF &polygon )
+{
+    QPolygonF mapped( polygon.size() );
+
+    const QPointF *p = polygon.constData();
+    QPointF *m = mapped.data();
+
+    for ( int i = 0; i < polygon.size(); i++ )
+    {
+        m[i].rx() = xMap.transform( p[i].x() );
+        m[i].ry() = yMap.transform( p[i].y() );
+    }
+
+    return mapped;
+}
+
+static QPainterPath qwtTransformPath( const QwtScaleMap &xMap,
+    const QwtScaleMap &yMap, const QPainterPath &path )
+{
+    // the control points of the curves are mapped like any other point,
+    // what is correct for linear scales only. For other scales
+    // drawLines() fits the translated points instead.
+
+    QPainterPath mapped = path;
+
+    for ( int i = 0; i < mapped.elementCount(); i++ )
+    {
+        const QPainterPath::Element element = mapped.elementAt( i );
+
+        mapped.setElementPositionAt( i,
+            xMap.transform( element.x ), yMap.transform( element.y ) );
+    }
+
+    return mapped;
+}
+
+namespace
+{
+    /*
+      Everything the result of the curve fitter depends on - beside
+      the samples and the fitter itself, that invalidate the cache
+     */
+    class FitKey
+    {
+    public:
+        FitKey():
+            fitSamples( false ),
+            fitPath( false ),
+            paintAttributes( 0 ),
+            from( 0 ),
+            to( -1 )
+        {
+            for ( int i = 0; i < 10; i++ )
+                maps[i] = 0.0;
+        }
+
+        void setMaps( const QwtScaleMap &xMap, const QwtScaleMap &yMap )
+        {
+            setMap( xMap, maps );
+            setMap( yMap, maps + 5 );
+        }
+
+        bool operator==( const FitKey &other ) const
+        {
+            if ( fitSamples != other.fitSamples || fitPath != other.fitPath
+                || paintAttributes != other.paintAttributes
+                || from != other.from || to != other.to )
+            {
+                return false;
+            }
+
+            for ( int i = 0; i < 10; i++ )
+            {
+                if ( maps[i] != other.maps[i] )
+                    return false;
+            }
+
+            return canvasRect == other.canvasRect
+                && clipRect == other.clipRect;
+        }
+
+        bool fitSamples;
+        bool fitPath;
+        int paintAttributes;
+
+        int from;
+        int to;
+
+        QRectF canvasRect;
+        QRectF clipRect;
+
+        double maps[10];
+
+    private:
+        static void setMap( const QwtScaleMap &map, double *values )
+        {
+            values[0] = map.s1();
+            values[1] = map.s2();
+            values[2] = map.p1();
+            values[3] = map.p2();
+
+            // the transformation itself can't be compared, but
+            // different transformations are mapping the center of
+            // the interval to different positions
+
+            values[4] = map.transform( 0.5 * ( map.s1() + map.s2() ) );
+        }
+    };
+
+    class FitCache
+    {
+    public:
+        FitCache():
+            isValid( false )
+        {
+        }
+
+        void invalidate()
+        {
+            isValid = false;
+            polygon.clear();
+            path = QPainterPath();
+        }
+
+        bool isValid;
+        FitKey key;
+
+        QPolygonF polygon;
+        QPainterPath path;
+    };
+}
+
 class QwtPlotCurve::PrivateData
 {
 public:
@@ -86,7 +236,8 @@ public:
         attributes( 0 ),
         paintAttributes( 
             QwtPlotCurve::ClipPolygons | QwtPlotCurve::FilterPoints ),
-        legendAttributes( 0 )
+        legendAttributes( 0 ),
+        spatialIndex( NULL )
     {
         curveFitter = new QwtSplineCurveFitter;
     }
@@ -95,6 +246,7 @@ public:
     {
         delete symbol;
         delete curveFitter;
+        delete spatialIndex;
     }
 
     QwtPlotCurve::CurveStyle style;
@@ -110,6 +262,11 @@ public:
     QwtPlotCurve::PaintAttributes paintAttributes;
 
     QwtPlotCurve::LegendAttributes legendAttributes;
+
+    // built on demand, when enabled
+    QwtSpatialIndex *spatialIndex;
+
+    FitCache fitCache;
 };
 
 /*!
@@ -526,66 +683,168 @@ void QwtPlotCurve::drawLines( QPainter *painter,
     }
     else
     {
-        QPolygonF polyline = mapper.toPolygonF( xMap, yMap, data(), from, to );
+        QPolygonF polyline;
+        QPainterPath curvePath;
 
-        if ( doFill )
+        // it might be better to extend and draw the curvePath, when
+        // filling, but for the moment we keep an implementation, where
+        // we translate the path back to a polyline.
+
+        const bool fitPath = doFit && !doFill
+            && d_data->curveFitter->mode() == QwtCurveFitter::Path;
+
+        const bool doClip = !doFill && testPaintAttribute( ClipPolygons );
+
+        FitCache &cache = d_data->fitCache;
+
+        // the control points of a path in plot coordinates can't
+        // be mapped by a non-linear transformation
+
+        const bool fitSamples = doFit && ( d_data->attributes & FitSamples )
+            && xMap.transformation() == NULL && yMap.transformation() == NULL;
+
+        if ( fitSamples )
         {
-            if ( doFit )
-            {
-                // it might be better to extend and draw the curvePath, but for 
-                // the moment we keep an implementation, where we translate the
-                // path back to a polyline.
+            FitKey key;
+            key.fitSamples = true;
+            key.fitPath = fitPath;
+            key.from = from;
+            key.to = to;
 
-                polyline = d_data->curveFitter->fitCurve( polyline );
-            }
+            QwtPlotProfiler::count( ( cache.isValid && cache.key == key )
+                ? QwtPlotProfiler::CacheHit : QwtPlotProfiler::CacheMiss );
 
-            if ( painter->pen().style() != Qt::NoPen )
+            if ( !( cache.isValid && cache.key == key ) )
             {
-                // here we are wasting memory for the filled copy,
-                // do polygon clipping twice etc .. TODO
+                cache.invalidate();
 
-                QPolygonF filled = polyline;
-                fillCurve( painter, xMap, yMap, canvasRect, filled );
-                filled.clear();
+                const QwtSeriesData<QPointF> *series = data();
 
-                if ( d_data->paintAttributes & ClipPolygons )
-                    polyline = QwtClipper::clipPolygonF( clipRect, polyline, false );
+                QPolygonF samples( to - from + 1 );
+                for ( int i = from; i <= to; i++ )
+                    samples[i - from] = series->sample( i );
 
-                QwtPainter::drawPolyline( painter, polyline );
+                QwtPlotProfiler::Timer timer( QwtPlotProfiler::Fitting );
+
+                if ( fitPath )
+                    cache.path = d_data->curveFitter->fitCurvePath( samples );
+                else
+                    cache.polygon = d_data->curveFitter->fitCurve( samples );
+
+                cache.key = key;
+                cache.isValid = true;
+            }
+
+            if ( fitPath )
+            {
+                curvePath = qwtTransformPath( xMap, yMap, cache.path );
             }
             else
             {
-                fillCurve( painter, xMap, yMap, canvasRect, polyline );
+                polyline = qwtTransformPolygon( xMap, yMap, cache.polygon );
+                if ( doClip )
+                    qwtClipPolyline( clipRect, polyline );
             }
         }
         else
         {
-            if ( testPaintAttribute( ClipPolygons ) )
+            FitKey key;
+
+            const bool doCache = doFit && testPaintAttribute( CacheFittedCurve );
+            if ( doCache )
             {
-                polyline = QwtClipper::clipPolygonF(
-                    clipRect, polyline, false );
+                key.fitPath = fitPath;
+                key.paintAttributes = d_data->paintAttributes;
+                key.from = from;
+                key.to = to;
+                key.canvasRect = canvasRect;
+                key.clipRect = clipRect;
+                key.setMaps( xMap, yMap );
+
+                QwtPlotProfiler::count( ( cache.isValid && cache.key == key )
+                    ? QwtPlotProfiler::CacheHit : QwtPlotProfiler::CacheMiss );
             }
 
-            if ( doFit )
+            if ( doCache && cache.isValid && cache.key == key )
             {
-                if ( d_data->curveFitter->mode() == QwtCurveFitter::Path )
+                polyline = cache.polygon;
+                curvePath = cache.path;
+            }
+            else
+            {
+                polyline = mapper.toPolygonF( xMap, yMap, data(), from, to );
+
+                if ( doClip )
+                    qwtClipPolyline( clipRect, polyline );
+
+                if ( fitPath )
                 {
-                    const QPainterPath curvePath = 
-                        d_data->curveFitter->fitCurvePath( polyline );
+                    QwtPlotProfiler::Timer timer( QwtPlotProfiler::Fitting );
 
-                    painter->drawPath( curvePath );
+                    curvePath = d_data->curveFitter->fitCurvePath( polyline );
+                    polyline.clear();
                 }
-                else
+                else if ( doFit )
                 {
+                    QwtPlotProfiler::Timer timer( QwtPlotProfiler::Fitting );
                     polyline = d_data->curveFitter->fitCurve( polyline );
-                    QwtPainter::drawPolyline( painter, polyline );
+                }
+
+                if ( doCache )
+                {
+                    cache.invalidate();
+
+                    cache.polygon = polyline;
+                    cache.path = curvePath;
+                    cache.key = key;
+                    cache.isValid = true;
                 }
             }
-            else
+        }
+
+        if ( doFill )
+        {
+            if ( painter->pen().style() != Qt::NoPen )
             {
+                /*
+                  fillCurve() closes the polygon by appending the points
+                  on the baseline, so it gets a copy of the polyline.
+                  The copy is taken from the scratch pool with room
+                  for the baseline points, so that closing it does not
+                  reallocate.
+                 */
+
+                const int numPoints = polyline.size();
+
+                QPolygonF filled = QwtScratchPool::take( numPoints + 2 );
+                filled.resize( numPoints );
+
+                ::memcpy( filled.data(), polyline.constData(),
+                    numPoints * sizeof( QPointF ) );
+
+                fillCurve( painter, xMap, yMap, canvasRect, filled );
+                QwtScratchPool::release( filled );
+
+                if ( d_data->paintAttributes & ClipPolygons )
+                    qwtClipPolyline( clipRect, polyline );
+
                 QwtPainter::drawPolyline( painter, polyline );
             }
+            else
+            {
+                fillCurve( painter, xMap, yMap, canvasRect, polyline );
+            }
+        }
+        else if ( fitPath )
+        {
+            painter->drawPath( curvePath );
+        }
+        else
+        {
+            QwtPainter::drawPolyline( painter, polyline );
         }
+
+        QwtScratchPool::release( polyline );
     }
 }
 
@@ -610,34 +869,19 @@ void QwtPlotCurve::drawSticks( QPainter *painter,
 
     const bool doAlign = QwtPainter::roundingAlignment( painter );
 
-    double x0 = xMap.transform( d_data->baseline );
-    double y0 = yMap.transform( d_data->baseline );
-    if ( doAlign )
-    {
-        x0 = qRound( x0 );
-        y0 = qRound( y0 );
-    }
+    QwtPointMapper mapper;
+    mapper.setFlag( QwtPointMapper::RoundPoints, doAlign );
+    mapper.setFlag( QwtPointMapper::WeedOutPoints,
+        testPaintAttribute( FilterPoints ) ||
+        testPaintAttribute( FilterPointsAggressive ) );
+    mapper.setFlag( QwtPointMapper::WeedOutIntermediatePoints,
+        doAlign && testPaintAttribute( FilterPointsAggressive ) );
 
-    const Qt::Orientation o = orientation();
+    QPolygonF sticks = mapper.toSticksF( xMap, yMap,
+        data(), from, to, orientation(), d_data->baseline );
 
-    const QwtSeriesData<QPointF> *series = data();
-
-    for ( int i = from; i <= to; i++ )
-    {
-        const QPointF sample = series->sample( i );
-        double xi = xMap.transform( sample.x() );
-        double yi = yMap.transform( sample.y() );
-        if ( doAlign )
-        {
-            xi = qRound( xi );
-            yi = qRound( yi );
-        }
-
-        if ( o == Qt::Horizontal )
-            QwtPainter::drawLine( painter, x0, yi, xi, yi );
-        else
-            QwtPainter::drawLine( painter, xi, y0, xi, yi );
-    }
+    QwtPainter::drawLines( painter, sticks.constData(), sticks.size() / 2 );
+    QwtScratchPool::release( sticks );
 
     painter->restore();
 }
@@ -691,6 +935,8 @@ void QwtPlotCurve::drawDots( QPainter *painter,
 
         QwtPainter::drawPoints( painter, points );
         fillCurve( painter, xMap, yMap, canvasRect, points );
+
+        QwtScratchPool::release( points );
     }
     else if ( d_data->paintAttributes & ImageBuffer )
     {
@@ -732,10 +978,11 @@ void QwtPlotCurve::drawDots( QPainter *painter,
         }
         else
         {
-            const QPolygonF points = mapper.toPointsF( 
+            QPolygonF points = mapper.toPointsF(
                 xMap, yMap, data(), from, to );
 
             QwtPainter::drawPoints( painter, points );
+            QwtScratchPool::release( points );
         }
     }
 }
@@ -761,47 +1008,20 @@ void QwtPlotCurve::drawSteps( QPainter *painter,
 {
     const bool doAlign = QwtPainter::roundingAlignment( painter );
 
-    QPolygonF polygon( 2 * ( to - from ) + 1 );
-    QPointF *points = polygon.data();
-
     bool inverted = orientation() == Qt::Vertical;
     if ( d_data->attributes & Inverted )
         inverted = !inverted;
 
-    const QwtSeriesData<QPointF> *series = data();
-
-    int i, ip;
-    for ( i = from, ip = 0; i <= to; i++, ip += 2 )
-    {
-        const QPointF sample = series->sample( i );
-        double xi = xMap.transform( sample.x() );
-        double yi = yMap.transform( sample.y() );
-        if ( doAlign )
-        {
-            xi = qRound( xi );
-            yi = qRound( yi );
-        }
-
-        if ( ip > 0 )
-        {
-            const QPointF &p0 = points[ip - 2];
-            QPointF &p = points[ip - 1];
-
-            if ( inverted )
-            {
-                p.rx() = p0.x();
-                p.ry() = yi;
-            }
-            else
-            {
-                p.rx() = xi;
-                p.ry() = p0.y();
-            }
-        }
+    QwtPointMapper mapper;
+    mapper.setFlag( QwtPointMapper::RoundPoints, doAlign );
+    mapper.setFlag( QwtPointMapper::WeedOutPoints,
+        testPaintAttribute( FilterPoints ) ||
+        testPaintAttribute( FilterPointsAggressive ) );
+    mapper.setFlag( QwtPointMapper::WeedOutIntermediatePoints,
+        doAlign && testPaintAttribute( FilterPointsAggressive ) );
 
-        points[ip].rx() = xi;
-        points[ip].ry() = yi;
-    }
+    QPolygonF polygon = mapper.toStepsF(
+        xMap, yMap, data(), from, to, inverted );
 
     if ( d_data->paintAttributes & ClipPolygons )
     {
@@ -810,10 +1030,11 @@ void QwtPlotCurve::drawSteps( QPainter *painter,
         const qreal pw = qMax( qreal( 1.0 ), painter->pen().widthF());
         clipRect = clipRect.adjusted(-pw, -pw, pw, pw);
 
-        const QPolygonF clipped = QwtClipper::clipPolygonF( 
+        QPolygonF clipped = QwtClipper::clipPolygonF(
             clipRect, polygon, false );
 
         QwtPainter::drawPolyline( painter, clipped );
+        QwtScratchPool::release( clipped );
     }
     else
     {
@@ -822,6 +1043,8 @@ void QwtPlotCurve::drawSteps( QPainter *painter,
 
     if ( d_data->brush.style() != Qt::NoBrush )
         fillCurve( painter, xMap, yMap, canvasRect, polygon );
+
+    QwtScratchPool::release( polygon );
 }
 
 
@@ -843,6 +1066,8 @@ void QwtPlotCurve::setCurveAttribute( CurveAttribute attribute, bool on )
     else
         d_data->attributes &= ~attribute;
 
+    d_data->fitCache.invalidate();
+
     itemChanged();
 }
 
@@ -869,14 +1094,20 @@ bool QwtPlotCurve::testCurveAttribute( CurveAttribute attribute ) const
   of painting huge series of points it might be better to execute the fitter
   on the curve points once and to cache the result in the QwtSeriesData object.
 
+  To avoid that the fitter is called for each replot, the fitted curve can
+  be cached ( CacheFittedCurve ) or calculated in plot coordinates
+  ( FitSamples ).
+
   \param curveFitter() Curve fitter
-  \sa Fitted
+  \sa Fitted, FitSamples, CacheFittedCurve
 */
 void QwtPlotCurve::setCurveFitter( QwtCurveFitter *curveFitter )
 {
     delete d_data->curveFitter;
     d_data->curveFitter = curveFitter;
 
+    d_data->fitCache.invalidate();
+
     itemChanged();
 }
 
@@ -899,7 +1130,8 @@ QwtCurveFitter *QwtPlotCurve::curveFitter() const
   \param xMap x map
   \param yMap y map
   \param canvasRect Contents rectangle of the canvas
-  \param polygon Polygon - will be modified !
+  \param polygon Polyline, that will be closed by closePolyline().
+                 The points of the polyline itself are not modified.
 
   \sa setBrush(), setBaseline(), setStyle()
 */
@@ -918,18 +1150,24 @@ void QwtPlotCurve::fillCurve( QPainter *painter,
     if ( !brush.color().isValid() )
         brush.setColor( d_data->pen.color() );
 
-    if ( d_data->paintAttributes & ClipPolygons )
-    {
-        const QRectF clipRect = qwtIntersectedClipRect( canvasRect, painter );
-        polygon = QwtClipper::clipPolygonF( clipRect, polygon, true );
-    }
-
     painter->save();
 
     painter->setPen( Qt::NoPen );
     painter->setBrush( brush );
 
-    QwtPainter::drawPolygon( painter, polygon );
+    if ( d_data->paintAttributes & ClipPolygons )
+    {
+        // a polygon inside of the clip rectangle is
+        // returned without copying it
+
+        const QRectF clipRect = qwtIntersectedClipRect( canvasRect, painter );
+        QwtPainter::drawPolygon( painter,
+            QwtClipper::clipPolygonF( clipRect, polygon, true ) );
+    }
+    else
+    {
+        QwtPainter::drawPolygon( painter, polygon );
+    }
 
     painter->restore();
 }
@@ -938,6 +1176,8 @@ void QwtPlotCurve::fillCurve( QPainter *painter,
   \brief Complete a polygon to be a closed polygon including the 
          area between the original polygon and the baseline.
 
+  The polygon is completed in place by appending 2 points on the baseline.
+
   \param painter Painter
   \param xMap X map
   \param yMap Y map
@@ -953,6 +1193,12 @@ void QwtPlotCurve::closePolyline( QPainter *painter,
     const bool doAlign = QwtPainter::roundingAlignment( painter );
 
     double baseline = d_data->baseline;
+
+    // resizing once, instead of appending twice
+    const int numPoints = polygon.size();
+    polygon.resize( numPoints + 2 );
+
+    QPointF *points = polygon.data();
     
     if ( orientation() == Qt::Vertical )
     {
@@ -963,8 +1209,8 @@ void QwtPlotCurve::closePolyline( QPainter *painter,
         if ( doAlign )
             refY = qRound( refY );
 
-        polygon += QPointF( polygon.last().x(), refY );
-        polygon += QPointF( polygon.first().x(), refY );
+        points[numPoints] = QPointF( points[numPoints - 1].x(), refY );
+        points[numPoints + 1] = QPointF( points[0].x(), refY );
     }
     else
     {
@@ -975,8 +1221,8 @@ void QwtPlotCurve::closePolyline( QPainter *painter,
         if ( doAlign )
             refX = qRound( refX );
 
-        polygon += QPointF( refX, polygon.last().y() );
-        polygon += QPointF( refX, polygon.first().y() );
+        points[numPoints] = QPointF( refX, points[numPoints - 1].y() );
+        points[numPoints + 1] = QPointF( refX, points[0].y() );
     }
 }
 
@@ -1006,17 +1252,23 @@ void QwtPlotCurve::drawSymbols( QPainter *painter, const QwtSymbol &symbol,
     const QRectF clipRect = qwtIntersectedClipRect( canvasRect, painter );
     mapper.setBoundingRect( clipRect );
 
-    const int chunkSize = 500;
+    // QwtSymbol::drawSymbols() can render larger chunks much faster,
+    // when being able to stamp its symbols into an image
+
+    const int chunkSize = testPaintAttribute( MinimizeMemory ) ? 500 : 100000;
 
     for ( int i = from; i <= to; i += chunkSize )
     {
         const int n = qMin( chunkSize, to - i + 1 );
 
-        const QPolygonF points = mapper.toPointsF( xMap, yMap,
+        QPolygonF points = mapper.toPointsF( xMap, yMap,
             data(), i, i + n - 1 );
 
         if ( points.size() > 0 )
             symbol.drawSymbols( painter, points );
+
+        // the next chunk is mapped into the same buffer
+        QwtScratchPool::release( points );
     }
 }
 
@@ -1062,8 +1314,10 @@ double QwtPlotCurve::baseline() const
               the position and the closest curve point
   \return Index of the closest curve point, or -1 if none can be found
           ( f.e when the curve has no points )
-  \note closestPoint() implements a dumb algorithm, that iterates
-        over all points
+  \note Without a spatial index closestPoint() implements a dumb algorithm,
+        that iterates over all points
+
+  \sa setSpatialIndexEnabled()
 */
 int QwtPlotCurve::closestPoint( const QPoint &pos, double *dist ) const
 {
@@ -1072,11 +1326,15 @@ int QwtPlotCurve::closestPoint( const QPoint &pos, double *dist ) const
     if ( plot() == NULL || numSamples <= 0 )
         return -1;
 
-    const QwtSeriesData<QPointF> *series = data();
-
     const QwtScaleMap xMap = plot()->canvasMap( xAxis() );
     const QwtScaleMap yMap = plot()->canvasMap( yAxis() );
 
+    const QwtSpatialIndex *spatial = spatialIndex();
+    if ( spatial )
+        return spatial->closestPoint( xMap, yMap, pos, dist );
+
+    const QwtSeriesData<QPointF> *series = data();
+
     int index = -1;
     double dmin = 1.0e10;
 
@@ -1100,6 +1358,109 @@ int QwtPlotCurve::closestPoint( const QPoint &pos, double *dist ) const
     return index;
 }
 
+/*!
+  \brief En/Disable a spatial index for the samples
+
+  The spatial index is a k-d tree, that allows to find the closest
+  points for a position or all points inside of a rectangle in
+  logarithmic time. It is intended for curves with many points, where
+  closestPoint() is called frequently - f.e. from a picker tracking
+  the mouse movements.
+
+  The index is built on the first request and is invalidated by
+  dataChanged(). It doesn't depend on the scales of the plot.
+
+  \param on On/Off
+  \sa isSpatialIndexEnabled(), spatialIndex(), closestPoint()
+
+  \note The index holds a copy of the points, what doubles the memory
+         needed for the samples.
+  \note When the samples are modified without calling setData(),
+         dataChanged() has to be called explicitly.
+*/
+void QwtPlotCurve::setSpatialIndexEnabled( bool on )
+{
+    if ( on == isSpatialIndexEnabled() )
+        return;
+
+    if ( on )
+    {
+        d_data->spatialIndex = new QwtSpatialIndex();
+    }
+    else
+    {
+        delete d_data->spatialIndex;
+        d_data->spatialIndex = NULL;
+    }
+}
+
+/*!
+  \return True, when the spatial index is enabled
+  \sa setSpatialIndexEnabled()
+ */
+bool QwtPlotCurve::isSpatialIndexEnabled() const
+{
+    return d_data->spatialIndex != NULL;
+}
+
+/*!
+  \brief Spatial index of the samples
+
+  The index is built, when it is requested for the first time
+  after modifying the samples. Its queries can be used for
+  implementing selections:
+
+  \code
+    const QwtSpatialIndex *index = curve->spatialIndex();
+    if ( index )
+    {
+        const QVector<int> indexes = index->pointsInRect(
+            plot->canvasMap( curve->xAxis() ),
+            plot->canvasMap( curve->yAxis() ), selectedRect );
+        ...
+    }
+  \endcode
+
+  \return Spatial index, or NULL, when the index is disabled
+  \sa setSpatialIndexEnabled(), QwtSpatialIndex
+ */
+const QwtSpatialIndex *QwtPlotCurve::spatialIndex() const
+{
+    QwtSpatialIndex *index = d_data->spatialIndex;
+
+    if ( index && !index->isBuilt() )
+        index->build( data() );
+
+    return index;
+}
+
+/*!
+  \brief Invalidate the cached fitted curve
+
+  The cache has to be invalidated, when the parameters of the
+  curve fitter have been modified.
+
+  \sa CacheFittedCurve, FitSamples, curveFitter()
+ */
+void QwtPlotCurve::invalidateCache()
+{
+    d_data->fitCache.invalidate();
+}
+
+/*!
+  Invalidate the spatial index and the fitted curve and call
+  QwtPlotSeriesItem::dataChanged()
+ */
+void QwtPlotCurve::dataChanged()
+{
+    if ( d_data->spatialIndex )
+        d_data->spatialIndex->reset();
+
+    d_data->fitCache.invalidate();
+
+    QwtPlotSeriesItem::dataChanged();
+}
+
 /*!
    \return Icon representing the curve on the legend
 
@@ -22,6 +22,7 @@ class QPolygonF;
 class QwtScaleMap;
 class QwtSymbol;
 class QwtCurveFitter;
+class QwtSpatialIndex;
 
 /*!
   \brief A plot item, that represents a series of points
@@ -125,7 +126,26 @@ public:
           If painting in QwtPlotCurve::Fitted mode is slow it might be better
           to fit the points, before they are passed to QwtPlotCurve.
          */
-        Fitted = 0x02
+        Fitted = 0x02,
+
+        /*!
+          Only in combination with Fitted.
+          The curve fitter is applied to the samples in plot coordinates
+          instead of the translated points. The fitted curve is calculated
+          once and only translated, when the scales have been changed.
+
+          As the result doesn't depend on the resolution of the paint device
+          it is intended for fitters, that interpolate the samples.
+          For fitters, that reduce the number of points, it has to be
+          considered, that the tolerance is in plot coordinates.
+
+          For scales with a non-linear transformation FitSamples is
+          ignored and the translated points are fitted, as the control
+          points of a Bezier curve can't be mapped point by point.
+
+          \note The fitted curve is invalidated by dataChanged().
+         */
+        FitSamples = 0x04
     };
 
     //! Curve attributes
@@ -222,13 +242,29 @@ public:
           The algorithm is very fast and effective for huge datasets, and can be used
           inside a replot cycle.
 
-          \note Implemented for QwtPlotCurve::Lines only
+          For QwtPlotCurve::Sticks all consecutive sticks being mapped to
+          the same row or column are merged into one stick.
+
+          \note Implemented for QwtPlotCurve::Lines, QwtPlotCurve::Steps
+                and QwtPlotCurve::Sticks only
           \note As this algo replaces many small lines by a long one
                 a nasty bug of the raster paint engine ( Qt 4.8, Qt 5.1 - 5.3 )
                 becomes more dominant. For these versions the bug can be
                 worked around by enabling the QwtPainter::polylineSplitting() mode.
          */
         FilterPointsAggressive = 0x10,
+
+        /*!
+          Cache the result of the curve fitter, when the curve is
+          displayed with the Fitted attribute. As long as the samples, the
+          scale maps and the geometry of the canvas are unchanged
+          the fitter is not called again.
+
+          \note The cache is invalidated by dataChanged(). When modifying
+                the curve fitter, invalidateCache() has to be called.
+          \sa FitSamples
+         */
+        CacheFittedCurve = 0x20
     };
 
     //! Paint attributes
@@ -257,6 +293,11 @@ public:
 
     virtual int closestPoint( const QPoint &pos, double *dist = NULL ) const;
 
+    void setSpatialIndexEnabled( bool on );
+    bool isSpatialIndexEnabled() const;
+
+    const QwtSpatialIndex *spatialIndex() const;
+
     double minXValue() const;
     double maxXValue() const;
     double minYValue() const;
@@ -284,6 +325,8 @@ public:
     void setCurveFitter( QwtCurveFitter * );
     QwtCurveFitter *curveFitter() const;
 
+    void invalidateCache();
+
     virtual void drawSeries( QPainter *,
         const QwtScaleMap &xMap, const QwtScaleMap &yMap,
         const QRectF &canvasRect, int from, int to ) const;
@@ -291,6 +334,7 @@ public:
     virtual QwtGraphic legendIcon( int index, const QSizeF & ) const;
 
 protected:
+    virtual void dataChanged();
 
     void init();
 
@@ -12,6 +12,8 @@
 #include "qwt_painter.h"
 #include "qwt_column_symbol.h"
 #include "qwt_scale_map.h"
+#include "qwt_math.h"
+#include "qwt_scratch_pool.h"
 #include <qstring.h>
 #include <qpainter.h>
 
@@ -39,7 +41,8 @@ public:
     PrivateData():
         baseline( 0.0 ),
         style( Columns ),
-        symbol( NULL )
+        symbol( NULL ),
+        paintAttributes( 0 )
     {
     }
 
@@ -54,6 +57,8 @@ public:
     QBrush brush;
     QwtPlotHistogram::HistogramStyle style;
     const QwtColumnSymbol *symbol;
+
+    QwtPlotHistogram::PaintAttributes paintAttributes;
 };
 
 /*!
@@ -94,6 +99,32 @@ void QwtPlotHistogram::init()
     setZ( 20.0 );
 }
 
+/*!
+  Specify an attribute how to draw the histogram
+
+  \param attribute Paint attribute
+  \param on On/Off
+  \sa testPaintAttribute()
+*/
+void QwtPlotHistogram::setPaintAttribute(
+    PaintAttribute attribute, bool on )
+{
+    if ( on )
+        d_data->paintAttributes |= attribute;
+    else
+        d_data->paintAttributes &= ~attribute;
+}
+
+/*!
+    \return True, when attribute is enabled
+    \sa PaintAttribute, setPaintAttribute()
+*/
+bool QwtPlotHistogram::testPaintAttribute(
+    PaintAttribute attribute ) const
+{
+    return ( d_data->paintAttributes & attribute );
+}
+
 /*!
   Set the histogram's drawing style
 
@@ -383,7 +414,10 @@ void QwtPlotHistogram::drawOutline( QPainter *painter,
 
     QwtIntervalSample previous;
 
-    QPolygonF polygon;
+    // 2 points for each sample + 5 for the baseline
+    QPolygonF polygon = QwtScratchPool::take( 2 * ( to - from + 1 ) + 5 );
+    polygon.resize( 0 );
+
     for ( int i = from; i <= to; i++ )
     {
         const QwtIntervalSample sample = this->sample( i );
@@ -441,6 +475,7 @@ void QwtPlotHistogram::drawOutline( QPainter *painter,
     }
 
     flushPolygon( painter, v0, polygon );
+    QwtScratchPool::release( polygon );
 }
 
 /*!
@@ -464,6 +499,55 @@ void QwtPlotHistogram::drawColumns( QPainter *painter,
 
     const QwtSeriesData<QwtIntervalSample> *series = data();
 
+    if ( d_data->paintAttributes & BatchColumns )
+    {
+        QVector<QwtColumnRect> columns;
+        columns.reserve( to - from + 1 );
+
+        for ( int i = from; i <= to; i++ )
+        {
+            const QwtIntervalSample sample = series->sample( i );
+            if ( !sample.interval.isNull() )
+                columns += columnRect( sample, xMap, yMap );
+        }
+
+        const QwtColumnSymbol *symbol = d_data->symbol;
+        if ( symbol && ( symbol->style() != QwtColumnSymbol::NoStyle ) )
+        {
+            symbol->drawColumns( painter,
+                columns.constData(), columns.size() );
+        }
+        else
+        {
+            const QVector<QwtColumnRect> merged =
+                QwtColumnSymbol::mergedColumns(
+                    columns.constData(), columns.size() );
+
+            const bool doAlign = QwtPainter::roundingAlignment( painter );
+
+            QVector<QRectF> rects;
+            rects.reserve( merged.size() );
+
+            for ( int i = 0; i < merged.size(); i++ )
+            {
+                QRectF r = merged[i].toRect();
+                if ( doAlign )
+                {
+                    r.setLeft( qRound( r.left() ) );
+                    r.setRight( qRound( r.right() ) );
+                    r.setTop( qRound( r.top() ) );
+                    r.setBottom( qRound( r.bottom() ) );
+                }
+
+                rects += r;
+            }
+
+            QwtPainter::drawRects( painter, rects.constData(), rects.size() );
+        }
+
+        return;
+    }
+
     for ( int i = from; i <= to; i++ )
     {
         const QwtIntervalSample sample = series->sample( i );
@@ -584,7 +668,9 @@ void QwtPlotHistogram::flushPolygon( QPainter *painter,
         painter->setPen( d_data->pen );
         QwtPainter::drawPolyline( painter, polygon );
     }
-    polygon.clear();
+
+    // keeping the buffer for the next polygon
+    polygon.resize( 0 );
 }
 
 /*!
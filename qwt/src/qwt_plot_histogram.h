@@ -76,12 +76,35 @@ public:
         UserStyle = 100
     };
 
+    /*!
+        Attributes to modify the drawing algorithm.
+        \sa setPaintAttribute(), testPaintAttribute()
+    */
+    enum PaintAttribute
+    {
+        /*!
+          In Columns style all columns are painted at once - either
+          by QwtColumnSymbol::drawColumns() or by one call of
+          QPainter::drawRects() using pen() and brush().
+          Columns narrower than a pixel are merged.
+
+          drawColumn() is not called, when this attribute is enabled.
+         */
+        BatchColumns = 0x01
+    };
+
+    //! Paint attributes
+    typedef QFlags<PaintAttribute> PaintAttributes;
+
     explicit QwtPlotHistogram( const QString &title = QString::null );
     explicit QwtPlotHistogram( const QwtText &title );
     virtual ~QwtPlotHistogram();
 
     virtual int rtti() const;
 
+    void setPaintAttribute( PaintAttribute, bool on = true );
+    bool testPaintAttribute( PaintAttribute ) const;
+
     void setPen( const QColor &, qreal width = 0.0, Qt::PenStyle = Qt::SolidLine );
     void setPen( const QPen & );
     const QPen &pen() const;
@@ -136,4 +159,6 @@ private:
     PrivateData *d_data;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS( QwtPlotHistogram::PaintAttributes )
+
 #endif
@@ -12,10 +12,169 @@
 #include "qwt_scale_map.h"
 #include "qwt_clipper.h"
 #include "qwt_painter.h"
+#include "qwt_math.h"
+#include "qwt_scratch_pool.h"
 #include <string.h>
 
 #include <qpainter.h>
 
+static inline void qwtAppendTubePoints( Qt::Orientation orientation,
+    const QwtScaleMap &intervalMap, double pos, double min, double max,
+    bool doAlign, QVector<QPointF> &lower, QVector<QPointF> &upper )
+{
+    double v1 = intervalMap.transform( min );
+    double v2 = intervalMap.transform( max );
+
+    if ( doAlign )
+    {
+        v1 = qRound( v1 );
+        v2 = qRound( v2 );
+    }
+
+    if ( orientation == Qt::Vertical )
+    {
+        lower += QPointF( pos, v1 );
+        upper += QPointF( pos, v2 );
+    }
+    else
+    {
+        lower += QPointF( v1, pos );
+        upper += QPointF( v2, pos );
+    }
+}
+
+static QPolygonF qwtFilteredTube( const QwtSeriesData<QwtIntervalSample> *series,
+    Qt::Orientation orientation, const QwtScaleMap &valueMap,
+    const QwtScaleMap &intervalMap, double minPos, double maxPos,
+    bool doAlign, int from, int to )
+{
+    /*
+      Consecutive samples inside of [minPos, maxPos], that are mapped
+      to the same pixel column, are reduced to the minimum of their lower
+      and the maximum of their upper bounds.
+
+      Of the samples beyond [minPos, maxPos] only those next to the
+      visible part are kept - at their exact positions, so that the
+      tube enters and leaves the canvas with the correct slope.
+     */
+
+    const int numSamples = to - from + 1;
+
+    QVector<QPointF> lower;
+    QVector<QPointF> upper;
+
+    // samples in the same column
+
+    int column = 0;
+    int count = 0;
+
+    double pos = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+
+    // the last sample of a sequence of samples beyond the canvas
+
+    int side = 0;
+    bool hasHeld = false;
+    double heldPos = 0.0;
+    QwtInterval heldInterval;
+
+    for ( int i = 0; i <= numSamples; i++ )
+    {
+        QwtIntervalSample sample;
+        double p = 0.0;
+        int s = 0;
+
+        if ( i < numSamples )
+        {
+            sample = series->sample( from + i );
+
+            p = valueMap.transform( sample.value );
+            if ( !qIsFinite( p ) )
+                continue;
+
+            if ( p < minPos )
+                s = -1;
+            else if ( p > maxPos )
+                s = 1;
+
+            if ( s == 0 && count > 0 && qRound( p ) == column )
+            {
+                min = qMin( min, sample.interval.minValue() );
+                max = qMax( max, sample.interval.maxValue() );
+
+                count++;
+                continue;
+            }
+        }
+
+        if ( count > 0 )
+        {
+            // a single sample keeps its exact position
+
+            double cp = ( count == 1 ) ? pos : column;
+            if ( doAlign )
+                cp = qRound( cp );
+
+            qwtAppendTubePoints( orientation, intervalMap,
+                cp, min, max, doAlign, lower, upper );
+
+            count = 0;
+        }
+
+        if ( i == numSamples )
+            break;
+
+        if ( hasHeld && s != side )
+        {
+            qwtAppendTubePoints( orientation, intervalMap, heldPos,
+                heldInterval.minValue(), heldInterval.maxValue(),
+                doAlign, lower, upper );
+
+            hasHeld = false;
+        }
+
+        if ( s == 0 )
+        {
+            column = qRound( p );
+            count = 1;
+
+            pos = p;
+            min = sample.interval.minValue();
+            max = sample.interval.maxValue();
+        }
+        else if ( s != side && !lower.isEmpty() )
+        {
+            // the first sample leaving the canvas
+
+            qwtAppendTubePoints( orientation, intervalMap, p,
+                sample.interval.minValue(), sample.interval.maxValue(),
+                doAlign, lower, upper );
+        }
+        else
+        {
+            hasHeld = true;
+            heldPos = p;
+            heldInterval = sample.interval;
+        }
+
+        side = s;
+    }
+
+    const int size = lower.size();
+
+    QPolygonF polygon = QwtScratchPool::take( 2 * size );
+    QPointF *points = polygon.data();
+
+    for ( int i = 0; i < size; i++ )
+    {
+        points[i] = lower[i];
+        points[2 * size - 1 - i] = upper[i];
+    }
+
+    return polygon;
+}
+
 static inline bool qwtIsHSampleInside( const QwtIntervalSample &sample,
     double xMin, double xMax, double yMin, double yMax )
 {
@@ -374,52 +533,79 @@ void QwtPlotIntervalCurve::drawTube( QPainter *painter,
 
     painter->save();
 
-    const size_t size = to - from + 1;
-    QPolygonF polygon( 2 * size );
-    QPointF *points = polygon.data();
+    QPolygonF polygon;
 
-    for ( uint i = 0; i < size; i++ )
+    if ( d_data->paintAttributes & FilterPointsAggressive )
     {
-        QPointF &minValue = points[i];
-        QPointF &maxValue = points[2 * size - 1 - i];
+        // the outline of the collected columns beyond the canvas
+        // needs to be invisible
+
+        const double m = qMax( 1.0, d_data->pen.widthF() ) + 2.0;
 
-        const QwtIntervalSample intervalSample = sample( from + i );
         if ( orientation() == Qt::Vertical )
         {
-            double x = xMap.transform( intervalSample.value );
-            double y1 = yMap.transform( intervalSample.interval.minValue() );
-            double y2 = yMap.transform( intervalSample.interval.maxValue() );
-            if ( doAlign )
-            {
-                x = qRound( x );
-                y1 = qRound( y1 );
-                y2 = qRound( y2 );
-            }
-
-            minValue.rx() = x;
-            minValue.ry() = y1;
-            maxValue.rx() = x;
-            maxValue.ry() = y2;
+            polygon = qwtFilteredTube( data(), Qt::Vertical, xMap, yMap,
+                canvasRect.left() - m, canvasRect.right() + m, doAlign, from, to );
         }
         else
         {
-            double y = yMap.transform( intervalSample.value );
-            double x1 = xMap.transform( intervalSample.interval.minValue() );
-            double x2 = xMap.transform( intervalSample.interval.maxValue() );
-            if ( doAlign )
+            polygon = qwtFilteredTube( data(), Qt::Horizontal, yMap, xMap,
+                canvasRect.top() - m, canvasRect.bottom() + m, doAlign, from, to );
+        }
+    }
+    else
+    {
+        const int size = to - from + 1;
+
+        polygon = QwtScratchPool::take( 2 * size );
+        QPointF *points = polygon.data();
+
+        for ( int i = 0; i < size; i++ )
+        {
+            QPointF &minValue = points[i];
+            QPointF &maxValue = points[2 * size - 1 - i];
+
+            const QwtIntervalSample intervalSample = sample( from + i );
+            if ( orientation() == Qt::Vertical )
             {
-                y = qRound( y );
-                x1 = qRound( x1 );
-                x2 = qRound( x2 );
+                double x = xMap.transform( intervalSample.value );
+                double y1 = yMap.transform( intervalSample.interval.minValue() );
+                double y2 = yMap.transform( intervalSample.interval.maxValue() );
+                if ( doAlign )
+                {
+                    x = qRound( x );
+                    y1 = qRound( y1 );
+                    y2 = qRound( y2 );
+                }
+
+                minValue.rx() = x;
+                minValue.ry() = y1;
+                maxValue.rx() = x;
+                maxValue.ry() = y2;
+            }
+            else
+            {
+                double y = yMap.transform( intervalSample.value );
+                double x1 = xMap.transform( intervalSample.interval.minValue() );
+                double x2 = xMap.transform( intervalSample.interval.maxValue() );
+                if ( doAlign )
+                {
+                    y = qRound( y );
+                    x1 = qRound( x1 );
+                    x2 = qRound( x2 );
+                }
+
+                minValue.rx() = x1;
+                minValue.ry() = y;
+                maxValue.rx() = x2;
+                maxValue.ry() = y;
             }
-
-            minValue.rx() = x1;
-            minValue.ry() = y;
-            maxValue.rx() = x2;
-            maxValue.ry() = y;
         }
     }
 
+    const size_t size = polygon.size() / 2;
+    const QPointF *points = polygon.constData();
+
     if ( d_data->brush.style() != Qt::NoBrush )
     {
         painter->setPen( QPen( Qt::NoPen ) );
@@ -428,10 +614,11 @@ void QwtPlotIntervalCurve::drawTube( QPainter *painter,
         if ( d_data->paintAttributes & ClipPolygons )
         {
             const qreal m = 1.0;
-            const QPolygonF p = QwtClipper::clipPolygonF(
+            QPolygonF p = QwtClipper::clipPolygonF(
                canvasRect.adjusted( -m, -m, m, m ), polygon, true );
 
             QwtPainter::drawPolygon( painter, p );
+            QwtScratchPool::release( p );
         }
         else
         {
@@ -449,17 +636,19 @@ void QwtPlotIntervalCurve::drawTube( QPainter *painter,
             qreal pw = qMax( qreal( 1.0 ), painter->pen().widthF() );
             const QRectF clipRect = canvasRect.adjusted( -pw, -pw, pw, pw );
 
-            QPolygonF p;
+            QPolygonF p = QwtScratchPool::take( size );
 
-            p.resize( size );
             ::memcpy( p.data(), points, size * sizeof( QPointF ) );
-            p = QwtClipper::clipPolygonF( clipRect, p );
-            QwtPainter::drawPolyline( painter, p );
+            QPolygonF clipped = QwtClipper::clipPolygonF( clipRect, p );
+            QwtPainter::drawPolyline( painter, clipped );
+            QwtScratchPool::release( clipped );
 
-            p.resize( size );
             ::memcpy( p.data(), points + size, size * sizeof( QPointF ) );
-            p = QwtClipper::clipPolygonF( clipRect, p );
-            QwtPainter::drawPolyline( painter, p );
+            clipped = QwtClipper::clipPolygonF( clipRect, p );
+            QwtPainter::drawPolyline( painter, clipped );
+            QwtScratchPool::release( clipped );
+
+            QwtScratchPool::release( p );
         }
         else
         {
@@ -469,6 +658,8 @@ void QwtPlotIntervalCurve::drawTube( QPainter *painter,
     }
 
     painter->restore();
+
+    QwtScratchPool::release( polygon );
 }
 
 /*!
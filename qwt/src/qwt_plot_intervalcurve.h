@@ -70,7 +70,24 @@ public:
         ClipPolygons = 0x01,
 
         //! Check if a symbol is on the plot canvas before painting it.
-        ClipSymbol   = 0x02
+        ClipSymbol   = 0x02,
+
+        /*!
+          Reduce the samples, that are mapped to the same pixel column
+          ( row for horizontal curves ), to the minimum of the lower and
+          the maximum of the upper bounds, before building the tube.
+          Samples beyond the canvas are collected in one column at each side.
+
+          The number of points of the tube is limited by the size of the canvas
+          and not by the number of samples. As drawing with the pen and brush
+          of the reduced tube is almost the same, this is a substantial
+          improvement for large series, where the values of the samples
+          are increasing.
+
+          \note The effect of this attribute is similar to
+                QwtPlotCurve::FilterPointsAggressive.
+         */
+        FilterPointsAggressive = 0x04
     };
 
     //! Paint attributes
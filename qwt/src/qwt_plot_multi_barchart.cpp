@@ -14,6 +14,7 @@
 #include <qpainter.h>
 #include <qpalette.h>
 #include <qmap.h>
+#include <qvector.h>
 
 inline static bool qwtIsIncreasing(
     const QwtScaleMap &map, const QVector<double> &values )
@@ -34,13 +35,16 @@ class QwtPlotMultiBarChart::PrivateData
 {
 public:
     PrivateData():
-        style( QwtPlotMultiBarChart::Grouped )
+        style( QwtPlotMultiBarChart::Grouped ),
+        paintAttributes( 0 )
     {
     }
 
     QwtPlotMultiBarChart::ChartStyle style;
     QList<QwtText> barTitles;
     QMap<int, QwtColumnSymbol *> symbolMap;
+
+    QwtPlotMultiBarChart::PaintAttributes paintAttributes;
 };
 
 /*!
@@ -82,6 +86,32 @@ int QwtPlotMultiBarChart::rtti() const
     return QwtPlotItem::Rtti_PlotMultiBarChart;
 }
 
+/*!
+  Specify an attribute how to draw the chart
+
+  \param attribute Paint attribute
+  \param on On/Off
+  \sa testPaintAttribute()
+*/
+void QwtPlotMultiBarChart::setPaintAttribute(
+    PaintAttribute attribute, bool on )
+{
+    if ( on )
+        d_data->paintAttributes |= attribute;
+    else
+        d_data->paintAttributes &= ~attribute;
+}
+
+/*!
+    \return True, when attribute is enabled
+    \sa PaintAttribute, setPaintAttribute()
+*/
+bool QwtPlotMultiBarChart::testPaintAttribute(
+    PaintAttribute attribute ) const
+{
+    return ( d_data->paintAttributes & attribute );
+}
+
 /*!
   Initialize data with an array of samples.
   \param samples Vector of points
@@ -389,6 +419,43 @@ void QwtPlotMultiBarChart::drawSeries( QPainter *painter,
     const QRectF br = data()->boundingRect();
     const QwtInterval interval( br.left(), br.right() );
 
+    if ( d_data->paintAttributes & BatchColumns )
+    {
+        // bars collected for each bar index
+        QVector< QVector<QwtColumnRect> > columns;
+
+        for ( int i = from; i <= to; i++ )
+        {
+            addSample( painter, xMap, yMap,
+                canvasRect, interval, i, sample( i ), &columns );
+        }
+
+        for ( int i = 0; i < columns.size(); i++ )
+        {
+            const QVector<QwtColumnRect> &barColumns = columns[i];
+            if ( barColumns.isEmpty() )
+                continue;
+
+            const QwtColumnSymbol *sym = symbol( i );
+            if ( sym )
+            {
+                sym->drawColumns( painter,
+                    barColumns.constData(), barColumns.size() );
+            }
+            else
+            {
+                // we build a temporary default symbol
+                QwtColumnSymbol sym( QwtColumnSymbol::Box );
+                sym.setLineWidth( 1 );
+                sym.setFrameStyle( QwtColumnSymbol::Plain );
+                sym.drawColumns( painter,
+                    barColumns.constData(), barColumns.size() );
+            }
+        }
+
+        return;
+    }
+
     painter->save();
 
     for ( int i = from; i <= to; i++ )
@@ -417,6 +484,32 @@ void QwtPlotMultiBarChart::drawSample( QPainter *painter,
     const QwtScaleMap &xMap, const QwtScaleMap &yMap,
     const QRectF &canvasRect, const QwtInterval &boundingInterval,
     int index, const QwtSetSample& sample ) const
+{
+    addSample( painter, xMap, yMap,
+        canvasRect, boundingInterval, index, sample, NULL );
+}
+
+/*!
+  Draw the bars of a sample, or collect them
+
+  \param painter Painter
+  \param xMap x map
+  \param yMap y map
+  \param canvasRect Contents rectangle of the canvas
+  \param boundingInterval Bounding interval of sample values
+  \param index Index of the sample to be painted
+  \param sample Sample value
+  \param columns Bars collected for each value index, when drawing
+                 the bars in a batch. The bars are drawn immediately,
+                 when columns is NULL.
+
+  \sa drawSample(), addBar()
+*/
+void QwtPlotMultiBarChart::addSample( QPainter *painter,
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QRectF &canvasRect, const QwtInterval &boundingInterval,
+    int index, const QwtSetSample& sample,
+    QVector< QVector<QwtColumnRect> > *columns ) const
 {
     if ( sample.set.size() <= 0 )
         return;
@@ -436,13 +529,13 @@ void QwtPlotMultiBarChart::drawSample( QPainter *painter,
 
     if ( d_data->style == Stacked )
     {
-        drawStackedBars( painter, xMap, yMap,
-            canvasRect, index, sampleW, sample );
+        addStackedBars( painter, xMap, yMap,
+            canvasRect, index, sampleW, sample, columns );
     }
     else
     {
-        drawGroupedBars( painter, xMap, yMap,
-            canvasRect, index, sampleW, sample );
+        addGroupedBars( painter, xMap, yMap,
+            canvasRect, index, sampleW, sample, columns );
     }
 }
 
@@ -463,6 +556,16 @@ void QwtPlotMultiBarChart::drawGroupedBars( QPainter *painter,
     const QwtScaleMap &xMap, const QwtScaleMap &yMap,
     const QRectF &canvasRect, int index, double sampleWidth,
     const QwtSetSample& sample ) const
+{
+    addGroupedBars( painter, xMap, yMap,
+        canvasRect, index, sampleWidth, sample, NULL );
+}
+
+void QwtPlotMultiBarChart::addGroupedBars( QPainter *painter,
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QRectF &canvasRect, int index, double sampleWidth,
+    const QwtSetSample& sample,
+    QVector< QVector<QwtColumnRect> > *columns ) const
 {
     Q_UNUSED( canvasRect );
 
@@ -494,7 +597,7 @@ void QwtPlotMultiBarChart::drawGroupedBars( QPainter *painter,
 
             barRect.vInterval = QwtInterval( y1, y2 ).normalized();
 
-            drawBar( painter, index, i, barRect );
+            addBar( painter, index, i, barRect, columns );
         }
     }
     else
@@ -521,7 +624,7 @@ void QwtPlotMultiBarChart::drawGroupedBars( QPainter *painter,
             if ( i != 0 )
                 barRect.vInterval.setBorderFlags( QwtInterval::ExcludeMinimum );
 
-            drawBar( painter, index, i, barRect );
+            addBar( painter, index, i, barRect, columns );
         }
     }
 }
@@ -543,6 +646,16 @@ void QwtPlotMultiBarChart::drawStackedBars( QPainter *painter,
     const QwtScaleMap &xMap, const QwtScaleMap &yMap,
     const QRectF &canvasRect, int index, 
     double sampleWidth, const QwtSetSample& sample ) const
+{
+    addStackedBars( painter, xMap, yMap,
+        canvasRect, index, sampleWidth, sample, NULL );
+}
+
+void QwtPlotMultiBarChart::addStackedBars( QPainter *painter,
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QRectF &canvasRect, int index,
+    double sampleWidth, const QwtSetSample& sample,
+    QVector< QVector<QwtColumnRect> > *columns ) const
 {
     Q_UNUSED( canvasRect ); // clipping the bars ?
 
@@ -586,7 +699,7 @@ void QwtPlotMultiBarChart::drawStackedBars( QPainter *painter,
             bar.vInterval = QwtInterval( y1, y2 ).normalized();
             bar.vInterval.setBorderFlags( borderFlags );
 
-            drawBar( painter, index, i, bar );
+            addBar( painter, index, i, bar, columns );
 
             sum += si;
 
@@ -628,7 +741,7 @@ void QwtPlotMultiBarChart::drawStackedBars( QPainter *painter,
             bar.hInterval = QwtInterval( x1, x2 ).normalized();
             bar.hInterval.setBorderFlags( borderFlags );
 
-            drawBar( painter, index, i, bar );
+            addBar( painter, index, i, bar, columns );
 
             sum += si;
 
@@ -678,6 +791,35 @@ void QwtPlotMultiBarChart::drawBar( QPainter *painter,
     delete specialSym;
 }
 
+/*!
+  Draw a bar, or collect it, when drawing the bars in a batch
+
+  \param painter Painter
+  \param sampleIndex Index of the sample
+  \param valueIndex Index of a value in a set
+  \param rect Directed target rectangle for the bar
+  \param columns Bars collected for each value index, or NULL
+                 when the bar has to be drawn immediately
+
+  \sa drawBar(), BatchColumns
+*/
+void QwtPlotMultiBarChart::addBar( QPainter *painter,
+    int sampleIndex, int valueIndex, const QwtColumnRect &rect,
+    QVector< QVector<QwtColumnRect> > *columns ) const
+{
+    if ( columns )
+    {
+        if ( valueIndex >= columns->size() )
+            columns->resize( valueIndex + 1 );
+
+        ( *columns )[valueIndex] += rect;
+    }
+    else
+    {
+        drawBar( painter, sampleIndex, valueIndex, rect );
+    }
+}
+
 /*!
   \return Information to be displayed on the legend
 
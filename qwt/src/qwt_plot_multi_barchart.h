@@ -61,6 +61,26 @@ public:
         Stacked
     };
 
+    /*!
+        Attributes to modify the drawing algorithm.
+        \sa setPaintAttribute(), testPaintAttribute()
+    */
+    enum PaintAttribute
+    {
+        /*!
+          The bars are collected for each value index and painted
+          at once by QwtColumnSymbol::drawColumns() using symbol()
+          or a default symbol. Bars narrower than a pixel are merged.
+
+          drawSample(), specialSymbol() and drawBar() are not called,
+          when this attribute is enabled.
+         */
+        BatchColumns = 0x01
+    };
+
+    //! Paint attributes
+    typedef QFlags<PaintAttribute> PaintAttributes;
+
     explicit QwtPlotMultiBarChart( const QString &title = QString::null );
     explicit QwtPlotMultiBarChart( const QwtText &title );
 
@@ -68,6 +88,9 @@ public:
 
     virtual int rtti() const;
 
+    void setPaintAttribute( PaintAttribute, bool on = true );
+    bool testPaintAttribute( PaintAttribute ) const;
+
     void setBarTitles( const QList<QwtText> & );
     QList<QwtText> barTitles() const;
 
@@ -120,8 +143,32 @@ protected:
 private:
     void init();
 
+    void addSample( QPainter *painter,
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QRectF &canvasRect, const QwtInterval &boundingInterval,
+        int index, const QwtSetSample& sample,
+        QVector< QVector<QwtColumnRect> > *columns ) const;
+
+    void addStackedBars( QPainter *painter,
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QRectF &canvasRect, int index,
+        double sampleWidth, const QwtSetSample& sample,
+        QVector< QVector<QwtColumnRect> > *columns ) const;
+
+    void addGroupedBars( QPainter *painter,
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QRectF &canvasRect, int index,
+        double sampleWidth, const QwtSetSample& sample,
+        QVector< QVector<QwtColumnRect> > *columns ) const;
+
+    void addBar( QPainter *, int sampleIndex, int barIndex,
+        const QwtColumnRect &,
+        QVector< QVector<QwtColumnRect> > *columns ) const;
+
     class PrivateData;
     PrivateData *d_data;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS( QwtPlotMultiBarChart::PaintAttributes )
+
 #endif
@@ -0,0 +1,256 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_plot_profile.h"
+#include "qwt_system_clock.h"
+#include <qthreadstorage.h>
+
+class QwtProfilerContext
+{
+public:
+    QwtProfilerContext():
+        record( NULL )
+    {
+    }
+
+    QwtPlotProfile::ItemRecord *record;
+};
+
+/*
+   QThreadStorage of Qt4 takes ownership of its data, so we can't
+   store the record pointer itself and need a context object.
+ */
+static QThreadStorage<QwtProfilerContext *> qwtProfilerContext;
+
+//! Constructor, initializing all values to 0
+QwtPlotProfile::ItemRecord::ItemRecord():
+    item( NULL ),
+    rtti( 0 ),
+    drawTime( 0.0 ),
+    mapTime( 0.0 ),
+    clipTime( 0.0 ),
+    renderImageTime( 0.0 ),
+    fitTime( 0.0 ),
+    pointsIn( 0 ),
+    pointsOut( 0 ),
+    cacheHits( 0 ),
+    cacheMisses( 0 ),
+    scratchBytesAllocated( 0 ),
+    scratchBytesReused( 0 ),
+    scratchBytesPeak( 0 )
+{
+}
+
+/*!
+  \return Time spent in draw(), that is not covered by the
+          mapping, clipping, image rendering and fitting phases
+ */
+double QwtPlotProfile::ItemRecord::paintTime() const
+{
+    const double t = drawTime - mapTime - clipTime
+        - renderImageTime - fitTime;
+    return qMax( t, 0.0 );
+}
+
+//! Constructor, initializing an empty profile
+QwtPlotProfile::QwtPlotProfile():
+    updateAxesTime( 0.0 ),
+    layoutTime( 0.0 ),
+    drawTime( 0.0 )
+{
+}
+
+//! \return true, when nothing has been recorded
+bool QwtPlotProfile::isNull() const
+{
+    return updateAxesTime == 0.0 && layoutTime == 0.0
+        && drawTime == 0.0 && items.isEmpty();
+}
+
+//! Clear all timings and records
+void QwtPlotProfile::reset()
+{
+    updateAxesTime = 0.0;
+    layoutTime = 0.0;
+    drawTime = 0.0;
+    items.clear();
+}
+
+//! \return Sum of updateAxesTime, layoutTime and drawTime
+double QwtPlotProfile::totalTime() const
+{
+    return updateAxesTime + layoutTime + drawTime;
+}
+
+//! \return Sum of the cache hits of all items
+int QwtPlotProfile::cacheHits() const
+{
+    int hits = 0;
+    for ( int i = 0; i < items.size(); i++ )
+        hits += items[i].cacheHits;
+
+    return hits;
+}
+
+//! \return Sum of the cache misses of all items
+int QwtPlotProfile::cacheMisses() const
+{
+    int misses = 0;
+    for ( int i = 0; i < items.size(); i++ )
+        misses += items[i].cacheMisses;
+
+    return misses;
+}
+
+/*!
+  Constructor
+
+  Starts a clock, when a record is active for the calling thread
+  \param phase Phase to be timed
+ */
+QwtPlotProfiler::Timer::Timer( Phase phase ):
+    d_phase( phase ),
+    d_isActive( QwtPlotProfiler::isActive() )
+{
+#if QT_VERSION >= 0x040800
+    if ( d_isActive )
+        d_timer.start();
+#else
+    d_clock = NULL;
+    if ( d_isActive )
+    {
+        d_clock = new QwtSystemClock();
+        d_clock->start();
+    }
+#endif
+}
+
+//! Destructor, adding the elapsed time to the active record
+QwtPlotProfiler::Timer::~Timer()
+{
+    if ( d_isActive )
+    {
+#if QT_VERSION >= 0x040800
+        QwtPlotProfiler::addTime( d_phase, d_timer.nsecsElapsed() / 1e6 );
+#else
+        QwtPlotProfiler::addTime( d_phase, d_clock->elapsed() );
+        delete d_clock;
+#endif
+    }
+}
+
+/*!
+  Set the record, that collects the measurements of the calling thread
+
+  \param record Record, or NULL to stop collecting
+  \return Record, that has been active before
+ */
+QwtPlotProfile::ItemRecord *QwtPlotProfiler::setActiveRecord(
+    QwtPlotProfile::ItemRecord *record )
+{
+    if ( !qwtProfilerContext.hasLocalData() )
+    {
+        if ( record == NULL )
+            return NULL;
+
+        qwtProfilerContext.setLocalData( new QwtProfilerContext() );
+    }
+
+    QwtProfilerContext *context = qwtProfilerContext.localData();
+
+    QwtPlotProfile::ItemRecord *oldRecord = context->record;
+    context->record = record;
+
+    return oldRecord;
+}
+
+/*!
+  \return Record, that collects the measurements of the calling thread
+  \sa setActiveRecord()
+ */
+QwtPlotProfile::ItemRecord *QwtPlotProfiler::activeRecord()
+{
+    if ( !qwtProfilerContext.hasLocalData() )
+        return NULL;
+
+    return qwtProfilerContext.localData()->record;
+}
+
+//! \return true, when a record is active for the calling thread
+bool QwtPlotProfiler::isActive()
+{
+    return activeRecord() != NULL;
+}
+
+/*!
+  Add a time to the active record
+
+  \param phase Phase
+  \param ms Time in milliseconds
+ */
+void QwtPlotProfiler::addTime( Phase phase, double ms )
+{
+    QwtPlotProfile::ItemRecord *record = activeRecord();
+    if ( record == NULL )
+        return;
+
+    switch( phase )
+    {
+        case Mapping:
+            record->mapTime += ms;
+            break;
+        case Clipping:
+            record->clipTime += ms;
+            break;
+        case RenderImage:
+            record->renderImageTime += ms;
+            break;
+        case Fitting:
+            record->fitTime += ms;
+            break;
+    }
+}
+
+/*!
+  Increment a counter of the active record
+
+  \param counter Counter
+  \param value Value to be added
+ */
+void QwtPlotProfiler::count( Counter counter, qint64 value )
+{
+    QwtPlotProfile::ItemRecord *record = activeRecord();
+    if ( record == NULL )
+        return;
+
+    switch( counter )
+    {
+        case PointsIn:
+            record->pointsIn += value;
+            break;
+        case PointsOut:
+            record->pointsOut += value;
+            break;
+        case CacheHit:
+            record->cacheHits += static_cast<int>( value );
+            break;
+        case CacheMiss:
+            record->cacheMisses += static_cast<int>( value );
+            break;
+        case ScratchAllocated:
+            record->scratchBytesAllocated += value;
+            break;
+        case ScratchReused:
+            record->scratchBytesReused += value;
+            break;
+        case ScratchPeak:
+            record->scratchBytesPeak = qMax( record->scratchBytesPeak, value );
+            break;
+    }
+}
@@ -0,0 +1,230 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_PLOT_PROFILE_H
+#define QWT_PLOT_PROFILE_H
+
+#include "qwt_global.h"
+#include <qstring.h>
+#include <qvector.h>
+#include <qmetatype.h>
+#if QT_VERSION >= 0x040800
+#include <qelapsedtimer.h>
+#endif
+
+class QwtPlotItem;
+class QwtSystemClock;
+
+/*!
+  \brief Timings and counters collected for one replot
+
+  QwtPlotProfile is the result of the opt-in instrumentation of QwtPlot.
+  It holds the time spent in QwtPlot::updateAxes(), in the layout
+  calculations and in the draw() method of each visible plot item.
+
+  The time of an item is broken down into the mapping of its points
+  ( QwtPointMapper ), the polygon clipping ( QwtClipper ), the rendering
+  of raster images ( QwtPlotRasterItem::renderImage() ), the curve
+  fitting ( QwtCurveFitter ) and the remaining painting operations.
+  The memory of temporary buffers is recorded from QwtScratchPool.
+
+  All times are in milliseconds.
+
+  \sa QwtPlot::setProfilingEnabled(), QwtPlot::lastProfile(),
+      QwtPlot::profileAvailable(), QwtPlotProfiler
+ */
+class QWT_EXPORT QwtPlotProfile
+{
+public:
+    //! \brief Timings and counters of a single plot item
+    class QWT_EXPORT ItemRecord
+    {
+    public:
+        ItemRecord();
+
+        double paintTime() const;
+
+        /*!
+          The item, that has been drawn. The pointer is for
+          identification only and might be dangling, when the
+          item has been deleted in the meantime.
+         */
+        const QwtPlotItem *item;
+
+        //! Runtime type information of the item
+        int rtti;
+
+        //! Title of the item
+        QString title;
+
+        //! Total time spent in QwtPlotItem::draw()
+        double drawTime;
+
+        //! Time spent in QwtPointMapper
+        double mapTime;
+
+        //! Time spent in QwtClipper
+        double clipTime;
+
+        //! Time spent in QwtPlotRasterItem::renderImage()
+        double renderImageTime;
+
+        //! Time spent in QwtCurveFitter
+        double fitTime;
+
+        //! Number of points passed to QwtPointMapper
+        qint64 pointsIn;
+
+        //! Number of points returned from QwtPointMapper
+        qint64 pointsOut;
+
+        //! Number of times, where a cached image/pixmap could be reused
+        int cacheHits;
+
+        //! Number of times, where a cached image/pixmap had to be rebuilt
+        int cacheMisses;
+
+        //! Bytes of the buffers, that have been allocated by QwtScratchPool
+        qint64 scratchBytesAllocated;
+
+        //! Bytes of the buffers, that have been reused from QwtScratchPool
+        qint64 scratchBytesReused;
+
+        //! Peak of the memory retained by QwtScratchPool
+        qint64 scratchBytesPeak;
+    };
+
+    QwtPlotProfile();
+
+    bool isNull() const;
+    void reset();
+
+    double totalTime() const;
+
+    int cacheHits() const;
+    int cacheMisses() const;
+
+    //! Time spent in QwtPlot::updateAxes()
+    double updateAxesTime;
+
+    //! Time spent in QwtPlot::updateLayout()
+    double layoutTime;
+
+    //! Time spent in QwtPlot::drawItems()
+    double drawTime;
+
+    //! Records of all items, that have been drawn
+    QVector<ItemRecord> items;
+};
+
+/*!
+  \brief Recorder for the timings and counters of QwtPlotProfile
+
+  QwtPlotProfiler is used by the instrumented code of the library
+  to report its measurements to the item record, that is currently active
+  for the calling thread. When no record is active - what is the case
+  when profiling has not been enabled - all methods are no-ops, with the
+  cost of checking a thread local pointer.
+
+  \par Example
+  \verbatim
+{
+    QwtPlotProfiler::Timer timer( QwtPlotProfiler::Mapping );
+    polyline = mapper.toPolygonF( xMap, yMap, data(), from, to );
+}
+\endverbatim
+
+  \sa QwtPlotProfile
+ */
+class QWT_EXPORT QwtPlotProfiler
+{
+public:
+    //! Phases of drawing a plot item, that can be timed
+    enum Phase
+    {
+        //! Translating points into paint device coordinates
+        Mapping,
+
+        //! Clipping polygons
+        Clipping,
+
+        //! Rendering the image of a raster item
+        RenderImage,
+
+        //! Running a curve fitter
+        Fitting
+    };
+
+    //! Counters, that can be incremented
+    enum Counter
+    {
+        //! Number of points passed to a point mapper
+        PointsIn,
+
+        //! Number of points returned from a point mapper
+        PointsOut,
+
+        //! A cached image/pixmap could be reused
+        CacheHit,
+
+        //! A cached image/pixmap had to be rebuilt
+        CacheMiss,
+
+        //! Bytes of a buffer allocated by QwtScratchPool
+        ScratchAllocated,
+
+        //! Bytes of a buffer reused from QwtScratchPool
+        ScratchReused,
+
+        /*!
+          Memory retained by QwtScratchPool. In opposite to the
+          other counters the maximum of the values is recorded.
+         */
+        ScratchPeak
+    };
+
+    /*!
+      \brief Scoped timer for a phase
+
+      The timer adds the time between construction and destruction
+      to the active record. When no record is active for the
+      calling thread, the timer does nothing.
+     */
+    class QWT_EXPORT Timer
+    {
+    public:
+        explicit Timer( Phase );
+        ~Timer();
+
+    private:
+        Q_DISABLE_COPY(Timer)
+
+        const Phase d_phase;
+        bool d_isActive;
+
+#if QT_VERSION >= 0x040800
+        QElapsedTimer d_timer;
+#else
+        QwtSystemClock *d_clock;
+#endif
+    };
+
+    static QwtPlotProfile::ItemRecord *setActiveRecord(
+        QwtPlotProfile::ItemRecord * );
+
+    static QwtPlotProfile::ItemRecord *activeRecord();
+    static bool isActive();
+
+    static void addTime( Phase, double ms );
+    static void count( Counter, qint64 value = 1 );
+};
+
+Q_DECLARE_METATYPE( QwtPlotProfile )
+
+#endif
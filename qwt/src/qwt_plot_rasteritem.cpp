@@ -10,6 +10,7 @@
 #include "qwt_plot_rasteritem.h"
 #include "qwt_scale_map.h"
 #include "qwt_painter.h"
+#include "qwt_plot_profile.h"
 #include <qapplication.h>
 #include <qdesktopwidget.h>
 #include <qpainter.h>
@@ -831,6 +832,9 @@ QImage QwtPlotRasterItem::compose(
         {
             image = d_data->cache.image;
         }
+
+        QwtPlotProfiler::count( image.isNull()
+            ? QwtPlotProfiler::CacheMiss : QwtPlotProfiler::CacheHit );
     }
 
     if ( image.isNull() )
@@ -849,7 +853,10 @@ QImage QwtPlotRasterItem::compose(
         const QwtScaleMap yyMap = 
             imageMap(Qt::Vertical, yMap, imageArea, imageSize, dy);
 
-        image = renderImage( xxMap, yyMap, imageArea, imageSize );
+        {
+            QwtPlotProfiler::Timer timer( QwtPlotProfiler::RenderImage );
+            image = renderImage( xxMap, yyMap, imageArea, imageSize );
+        }
 
         if ( doCache )
         {
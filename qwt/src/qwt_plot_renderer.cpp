@@ -11,9 +11,15 @@
 #include "qwt_plot.h"
 #include "qwt_painter.h"
 #include "qwt_plot_layout.h"
+#include "qwt_plot_seriesitem.h"
+#include "qwt_point_mapper.h"
+#include "qwt_graphic.h"
+#include "qwt_painter_command.h"
 #include "qwt_abstract_legend.h"
 #include "qwt_scale_widget.h"
 #include "qwt_scale_engine.h"
+#include "qwt_scale_map.h"
+#include "qwt_scale_div.h"
 #include "qwt_text.h"
 #include "qwt_text_label.h"
 #include "qwt_math.h"
@@ -27,6 +33,9 @@
 #include <qstyle.h>
 #include <qstyleoption.h>
 #include <qimagewriter.h>
+#include <qimage.h>
+#include <qpainterpath.h>
+#include <qpointer.h>
 
 #ifndef QWT_NO_SVG
 #ifdef QT_SVG_LIB
@@ -96,17 +105,415 @@ static QPainterPath qwtCanvasClip(
     return clipPath;
 }
 
+class QwtRenderLayout
+{
+public:
+    QRectF titleRect;
+    QRectF footerRect;
+    QRectF legendRect;
+    QRectF canvasRect;
+
+    QRectF scaleRect[QwtPlot::axisCnt];
+    int startDist[QwtPlot::axisCnt];
+    int endDist[QwtPlot::axisCnt];
+    int baseDist[QwtPlot::axisCnt];
+
+    QwtScaleMap maps[QwtPlot::axisCnt];
+};
+
+class QwtRenderCache
+{
+public:
+    QwtRenderCache():
+        isValid( false ),
+        dpiX( 0 ),
+        dpiY( 0 ),
+        renderHints( 0 )
+    {
+    }
+
+    bool matches( const QwtPlot *plot, const QRectF &plotRect,
+        int deviceDpiX, int deviceDpiY,
+        QPainter::RenderHints painterHints ) const
+    {
+        if ( !isValid || plot != this->plot.data() || plotRect != rect
+            || deviceDpiX != dpiX || deviceDpiY != dpiY
+            || painterHints != renderHints )
+        {
+            return false;
+        }
+
+        for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
+        {
+            if ( plot->axisScaleDiv( axisId ) != scaleDivs[axisId] )
+                return false;
+        }
+
+        return true;
+    }
+
+    void invalidate()
+    {
+        isValid = false;
+        decorations = QImage();
+    }
+
+    bool isValid;
+
+    // QPointer, so that a deleted plot never matches
+    QPointer<QwtPlot> plot;
+
+    QRectF rect;
+    int dpiX;
+    int dpiY;
+    QPainter::RenderHints renderHints;
+    QwtScaleDiv scaleDivs[QwtPlot::axisCnt];
+
+    QwtRenderLayout layout;
+    QImage decorations;
+};
+
+static inline bool qwtCanCacheImage( const QPainter *painter )
+{
+    // the pre-rendered decorations can be used, when the
+    // painter draws to a raster device without scaling
+
+    if ( painter->paintEngine()->type() != QPaintEngine::Raster )
+        return false;
+
+    return painter->transform().type() <= QTransform::TxTranslate;
+}
+
+static void qwtRenderDecorations( const QwtPlotRenderer *renderer,
+    const QwtPlot *plot, QPainter *painter, const QwtRenderLayout &layout )
+{
+    if ( !renderer->testDiscardFlag( QwtPlotRenderer::DiscardTitle )
+        && ( !plot->titleLabel()->text().isEmpty() ) )
+    {
+        renderer->renderTitle( plot, painter, layout.titleRect );
+    }
+
+    if ( !renderer->testDiscardFlag( QwtPlotRenderer::DiscardFooter )
+        && ( !plot->footerLabel()->text().isEmpty() ) )
+    {
+        renderer->renderFooter( plot, painter, layout.footerRect );
+    }
+
+    if ( !renderer->testDiscardFlag( QwtPlotRenderer::DiscardLegend )
+        && plot->legend() && !plot->legend()->isEmpty() )
+    {
+        renderer->renderLegend( plot, painter, layout.legendRect );
+    }
+
+    for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
+    {
+        if ( plot->axisWidget( axisId ) )
+        {
+            renderer->renderScale( plot, painter, axisId,
+                layout.startDist[axisId], layout.endDist[axisId],
+                layout.baseDist[axisId], layout.scaleRect[axisId] );
+        }
+    }
+}
+
+static bool qwtIsVectorDevice( const QPainter *painter )
+{
+    switch( painter->paintEngine()->type() )
+    {
+        case QPaintEngine::Pdf:
+        case QPaintEngine::SVG:
+        case QPaintEngine::Picture:
+#if QT_VERSION < 0x050000
+        case QPaintEngine::PostScript:
+#endif
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+static size_t qwtNumVertices( const QwtPlotItem *item )
+{
+    const QwtPlotSeriesItem *seriesItem =
+        dynamic_cast<const QwtPlotSeriesItem *>( item );
+
+    return seriesItem ? seriesItem->dataSize() : 0;
+}
+
+static size_t qwtNumVertices( const QwtGraphic &graphic )
+{
+    size_t numVertices = 0;
+
+    const QVector<QwtPainterCommand> &commands = graphic.commands();
+    for ( int i = 0; i < commands.size(); i++ )
+    {
+        switch( commands[i].type() )
+        {
+            case QwtPainterCommand::Path:
+                numVertices += commands[i].path()->elementCount();
+                break;
+
+            case QwtPainterCommand::Pixmap:
+            case QwtPainterCommand::Image:
+                numVertices++;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    return numVertices;
+}
+
+static void qwtDrawItem( QPainter *painter, const QwtPlotItem *item,
+    const QRectF &canvasRect, const QwtScaleMap *maps )
+{
+    painter->setRenderHint( QPainter::Antialiasing,
+        item->testRenderHint( QwtPlotItem::RenderAntialiased ) );
+    painter->setRenderHint( QPainter::HighQualityAntialiasing,
+        item->testRenderHint( QwtPlotItem::RenderAntialiased ) );
+
+    item->draw( painter, maps[item->xAxis()], maps[item->yAxis()], canvasRect );
+}
+
+static QPainterPath qwtWeededPath( const QPainterPath &path,
+    const QTransform &transform )
+{
+    if ( transform.type() > QTransform::TxScale
+        || !transform.isInvertible() )
+    {
+        return path;
+    }
+
+    for ( int i = 0; i < path.elementCount(); i++ )
+    {
+        if ( path.elementAt( i ).isCurveTo() )
+            return path;
+    }
+
+    const QTransform invertedTransform = transform.inverted();
+
+    /*
+      The points are in device pixels. Of all consecutive points
+      in the same pixel column only the first, the minimum, the
+      maximum and the last point are left.
+     */
+    QwtPointMapper mapper;
+    mapper.setFlag( QwtPointMapper::RoundPoints, true );
+    mapper.setFlag( QwtPointMapper::WeedOutIntermediatePoints, true );
+
+    const QwtScaleMap map; // identity
+
+    QPainterPath weededPath;
+    weededPath.setFillRule( path.fillRule() );
+
+    QPolygonF polyline;
+
+    for ( int i = 0; i <= path.elementCount(); i++ )
+    {
+        if ( i == path.elementCount() || path.elementAt( i ).isMoveTo() )
+        {
+            if ( !polyline.isEmpty() )
+            {
+                const bool isClosed = polyline.size() > 2
+                    && polyline.first() == polyline.last();
+
+                const QwtPointSeriesData series( polyline );
+
+                weededPath.addPolygon( invertedTransform.map(
+                    mapper.toPolygonF( map, map, &series, 0, polyline.size() - 1 ) ) );
+
+                if ( isClosed )
+                    weededPath.closeSubpath();
+
+                polyline.clear();
+            }
+        }
+
+        if ( i < path.elementCount() )
+        {
+            const QPainterPath::Element &element = path.elementAt( i );
+            polyline += transform.map( QPointF( element.x, element.y ) );
+        }
+    }
+
+    return weededPath;
+}
+
+class QwtWeedingGraphic: public QwtGraphic
+{
+public:
+    /*
+      A graphic, that weeds out the vertices of the recorded paths,
+      that are in the same pixel of the paint device.
+     */
+    QwtWeedingGraphic()
+    {
+    }
+
+protected:
+    virtual void updateState( const QPaintEngineState &state )
+    {
+        if ( state.state() & QPaintEngine::DirtyTransform )
+            d_transform = state.transform();
+
+        QwtGraphic::updateState( state );
+    }
+
+    virtual void drawPath( const QPainterPath &path )
+    {
+        QwtGraphic::drawPath( qwtWeededPath( path, d_transform ) );
+    }
+
+private:
+    QTransform d_transform;
+};
+
+static bool qwtWeedItem( QPainter *painter, const QwtPlotItem *item,
+    const QRectF &canvasRect, const QwtScaleMap *maps, size_t budget )
+{
+    /*
+      The item is recorded with the scale of the paint device, so that
+      the vertices can be weeded out in the pixel grid of the device.
+      The attributes of the item are left untouched.
+     */
+
+    const QTransform transform = painter->transform();
+    if ( transform.type() > QTransform::TxScale
+        || transform.m11() == 0.0 || transform.m22() == 0.0 )
+    {
+        return false;
+    }
+
+    const QTransform deviceScale =
+        QTransform::fromScale( transform.m11(), transform.m22() );
+
+    QwtWeedingGraphic graphic;
+
+    QPainter graphicPainter( &graphic );
+    graphicPainter.setWorldTransform( deviceScale );
+    qwtDrawItem( &graphicPainter, item, canvasRect, maps );
+    graphicPainter.end();
+
+    if ( qwtNumVertices( graphic ) > budget )
+        return false;
+
+    // the recorded commands already include the scale of the device
+    painter->setWorldTransform( deviceScale.inverted(), true );
+    graphic.render( painter );
+
+    return true;
+}
+
+static void qwtRasterizeItem( QPainter *painter, const QwtPlotItem *item,
+    const QRectF &canvasRect, const QwtScaleMap *maps )
+{
+    // an image with the resolution of the paint device
+
+    const QTransform transform = painter->transform();
+    const QRect imageRect = transform.mapRect( canvasRect ).toAlignedRect();
+
+    QImage image( imageRect.size(), QImage::Format_ARGB32_Premultiplied );
+    if ( image.isNull() )
+        return;
+
+    const double mmToInch = 1.0 / 25.4;
+
+    const QPaintDevice *device = painter->device();
+
+    image.setDotsPerMeterX( qRound( device->logicalDpiX() * mmToInch * 1000.0 ) );
+    image.setDotsPerMeterY( qRound( device->logicalDpiY() * mmToInch * 1000.0 ) );
+    image.fill( Qt::transparent );
+
+    QPainter imagePainter( &image );
+    imagePainter.translate( -imageRect.topLeft() );
+    imagePainter.setWorldTransform( transform, true );
+    imagePainter.setClipRect( canvasRect );
+
+    qwtDrawItem( &imagePainter, item, canvasRect, maps );
+
+    imagePainter.end();
+
+    painter->drawImage( transform.inverted().mapRect( QRectF( imageRect ) ), image );
+}
+
+static void qwtDrawItems( const QwtPlot *plot, QPainter *painter,
+    const QRectF &canvasRect, const QwtScaleMap *maps,
+    int budget, QwtPlotRenderer::DenseItemPolicy policy )
+{
+    const QwtPlotItemList& itmList = plot->itemList();
+
+    bool hasDenseItems = false;
+    if ( budget > 0 && qwtIsVectorDevice( painter ) )
+    {
+        for ( QwtPlotItemIterator it = itmList.begin();
+            it != itmList.end(); ++it )
+        {
+            const QwtPlotItem *item = *it;
+            if ( item && item->isVisible()
+                && qwtNumVertices( item ) > size_t( budget ) )
+            {
+                hasDenseItems = true;
+                break;
+            }
+        }
+    }
+
+    if ( !hasDenseItems )
+    {
+        plot->drawItems( painter, canvasRect, maps );
+        return;
+    }
+
+    for ( QwtPlotItemIterator it = itmList.begin();
+        it != itmList.end(); ++it )
+    {
+        const QwtPlotItem *item = *it;
+        if ( item == NULL || !item->isVisible() )
+            continue;
+
+        painter->save();
+
+        if ( qwtNumVertices( item ) <= size_t( budget ) )
+        {
+            qwtDrawItem( painter, item, canvasRect, maps );
+        }
+        else
+        {
+            bool done = false;
+            if ( policy == QwtPlotRenderer::WeedDenseItems )
+                done = qwtWeedItem( painter, item, canvasRect, maps, budget );
+
+            if ( !done )
+                qwtRasterizeItem( painter, item, canvasRect, maps );
+        }
+
+        painter->restore();
+    }
+}
+
 class QwtPlotRenderer::PrivateData
 {
 public:
     PrivateData():
         discardFlags( QwtPlotRenderer::DiscardNone ),
-        layoutFlags( QwtPlotRenderer::DefaultLayout )
+        layoutFlags( QwtPlotRenderer::DefaultLayout ),
+        vertexBudget( 0 ),
+        denseItemPolicy( QwtPlotRenderer::WeedDenseItems ),
+        cacheEnabled( false )
     {
     }
 
     QwtPlotRenderer::DiscardFlags discardFlags;
     QwtPlotRenderer::LayoutFlags layoutFlags;
+
+    int vertexBudget;
+    QwtPlotRenderer::DenseItemPolicy denseItemPolicy;
+
+    bool cacheEnabled;
+    QwtRenderCache cache;
 };
 
 /*! 
@@ -139,6 +546,8 @@ void QwtPlotRenderer::setDiscardFlag( DiscardFlag flag, bool on )
         d_data->discardFlags |= flag;
     else
         d_data->discardFlags &= ~flag;
+
+    d_data->cache.invalidate();
 }
 
 /*!
@@ -160,6 +569,7 @@ bool QwtPlotRenderer::testDiscardFlag( DiscardFlag flag ) const
 void QwtPlotRenderer::setDiscardFlags( DiscardFlags flags )
 {
     d_data->discardFlags = flags;
+    d_data->cache.invalidate();
 }
 
 /*!
@@ -185,6 +595,8 @@ void QwtPlotRenderer::setLayoutFlag( LayoutFlag flag, bool on )
         d_data->layoutFlags |= flag;
     else
         d_data->layoutFlags &= ~flag;
+
+    d_data->cache.invalidate();
 }
 
 /*!
@@ -206,6 +618,7 @@ bool QwtPlotRenderer::testLayoutFlag( LayoutFlag flag ) const
 void QwtPlotRenderer::setLayoutFlags( LayoutFlags flags )
 {
     d_data->layoutFlags = flags;
+    d_data->cache.invalidate();
 }
 
 /*!
@@ -217,6 +630,120 @@ QwtPlotRenderer::LayoutFlags QwtPlotRenderer::layoutFlags() const
     return d_data->layoutFlags;
 }
 
+/*!
+  \brief En/Disable caching of the decorations
+
+  For exporting the same plot many times - f.e. with different
+  curves, but identical scales - the renderer can work as a render
+  session, that reuses the results of the previous run:
+
+  - The geometry of all components of the plot, what saves the
+    expensive measuring of all tick labels. This is done for all
+    types of paint devices.
+  - The title, footer, legend and scales pre-rendered into an image.
+    This is done only, when rendering to a raster device ( f.e. QImage )
+    without scaling.
+
+  For raster targets only the canvas has to be rendered again.
+  For all other targets - like QPicture, QPrinter, PDF or SVG
+  documents or scaled painters - the decorations are still painted
+  for each run, to keep them as vector graphics.
+
+  The cache is keyed on the plot, the target rectangle, the resolution
+  and the render hints of the painter and the scale divisions of the plot.
+  Any other modification,
+  that affects the decorations ( titles, fonts, legend entries ... )
+  needs to be followed by invalidateCache().
+
+  The cache is disabled by default.
+
+  \param on On/Off
+  \sa isCacheEnabled(), invalidateCache()
+ */
+void QwtPlotRenderer::setCacheEnabled( bool on )
+{
+    if ( on != d_data->cacheEnabled )
+    {
+        d_data->cacheEnabled = on;
+        d_data->cache.invalidate();
+    }
+}
+
+/*!
+  \return True, when caching of the decorations is enabled
+  \sa setCacheEnabled(), invalidateCache()
+ */
+bool QwtPlotRenderer::isCacheEnabled() const
+{
+    return d_data->cacheEnabled;
+}
+
+/*!
+  Invalidate the cached layout and decorations
+  \sa setCacheEnabled()
+ */
+void QwtPlotRenderer::invalidateCache()
+{
+    d_data->cache.invalidate();
+}
+
+/*!
+  \brief Set a budget for the number of vertices of an item
+
+  When rendering to a vector device ( PDF, SVG ... ) each point of a curve
+  ends up in the document. For huge series this results in documents,
+  that are slow to write and to display.
+
+  Items with more samples than the budget are handled according to the
+  denseItemPolicy(), while all other items, the scales and texts
+  are rendered as vectors.
+
+  The number of vertices is estimated from the number of samples
+  of series items. All other items are always rendered as vectors.
+
+  As long as no item exceeds the budget the items are painted
+  by QwtPlot::drawItems(). Otherwise the items are painted one by one
+  without calling it.
+
+  \param numVertices Maximum number of vertices,
+                     <= 0 disables the budget ( default )
+
+  \sa vertexBudget(), setDenseItemPolicy()
+ */
+void QwtPlotRenderer::setVertexBudget( int numVertices )
+{
+    d_data->vertexBudget = qMax( numVertices, 0 );
+}
+
+/*!
+  \return Budget for the number of vertices of an item, 0 when disabled
+  \sa setVertexBudget()
+ */
+int QwtPlotRenderer::vertexBudget() const
+{
+    return d_data->vertexBudget;
+}
+
+/*!
+  Set the policy for items exceeding the vertex budget
+
+  \param policy Policy
+  \sa denseItemPolicy(), setVertexBudget()
+ */
+void QwtPlotRenderer::setDenseItemPolicy( DenseItemPolicy policy )
+{
+    d_data->denseItemPolicy = policy;
+}
+
+/*!
+  \return Policy for items exceeding the vertex budget
+  \sa setDenseItemPolicy(), setVertexBudget()
+ */
+QwtPlotRenderer::DenseItemPolicy QwtPlotRenderer::denseItemPolicy() const
+{
+    return d_data->denseItemPolicy;
+}
+
 /*!
   Render a plot to a file
 
@@ -533,83 +1060,135 @@ void QwtPlotRenderer::render( QwtPlot *plot,
         }
     }
 
-    // Calculate the layout for the document.
+    const int dpiX = painter->device()->logicalDpiX();
+    const int dpiY = painter->device()->logicalDpiY();
 
-    QwtPlotLayout::Options layoutOptions = QwtPlotLayout::IgnoreScrollbars;
+    QwtRenderCache &cache = d_data->cache;
 
-    if ( ( d_data->layoutFlags & FrameWithScales ) ||
-        ( d_data->discardFlags & DiscardCanvasFrame ) )
-    {
-        layoutOptions |= QwtPlotLayout::IgnoreFrames;
-    } 
+    const bool cacheHit = d_data->cacheEnabled &&
+        cache.matches( plot, plotRect, dpiX, dpiY, painter->renderHints() );
 
+    QwtRenderLayout renderLayout;
 
-    if ( d_data->discardFlags & DiscardLegend )
-        layoutOptions |= QwtPlotLayout::IgnoreLegend;
+    if ( cacheHit )
+    {
+        renderLayout = cache.layout;
+    }
+    else
+    {
+        // Calculate the layout for the document.
 
-    if ( d_data->discardFlags & DiscardTitle )
-        layoutOptions |= QwtPlotLayout::IgnoreTitle;
+        QwtPlotLayout::Options layoutOptions = QwtPlotLayout::IgnoreScrollbars;
 
-    if ( d_data->discardFlags & DiscardFooter )
-        layoutOptions |= QwtPlotLayout::IgnoreFooter;
+        if ( ( d_data->layoutFlags & FrameWithScales ) ||
+            ( d_data->discardFlags & DiscardCanvasFrame ) )
+        {
+            layoutOptions |= QwtPlotLayout::IgnoreFrames;
+        } 
 
-    layout->activate( plot, layoutRect, layoutOptions );
 
-    // canvas
+        if ( d_data->discardFlags & DiscardLegend )
+            layoutOptions |= QwtPlotLayout::IgnoreLegend;
 
-    QwtScaleMap maps[QwtPlot::axisCnt];
-    buildCanvasMaps( plot, layout->canvasRect(), maps );
-    if ( updateCanvasMargins( plot, layout->canvasRect(), maps ) )
-    {
-        // recalculate maps and layout, when the margins
-        // have been changed
+        if ( d_data->discardFlags & DiscardTitle )
+            layoutOptions |= QwtPlotLayout::IgnoreTitle;
+
+        if ( d_data->discardFlags & DiscardFooter )
+            layoutOptions |= QwtPlotLayout::IgnoreFooter;
 
         layout->activate( plot, layoutRect, layoutOptions );
-        buildCanvasMaps( plot, layout->canvasRect(), maps );
-    }
 
-    // now start painting
+        // canvas
 
-    painter->save();
-    painter->setWorldTransform( transform, true );
+        buildCanvasMaps( plot, layout->canvasRect(), renderLayout.maps );
+        if ( updateCanvasMargins( plot, layout->canvasRect(), renderLayout.maps ) )
+        {
+            // recalculate maps and layout, when the margins
+            // have been changed
 
-    renderCanvas( plot, painter, layout->canvasRect(), maps );
+            layout->activate( plot, layoutRect, layoutOptions );
+            buildCanvasMaps( plot, layout->canvasRect(), renderLayout.maps );
+        }
 
-    if ( !( d_data->discardFlags & DiscardTitle )
-        && ( !plot->titleLabel()->text().isEmpty() ) )
-    {
-        renderTitle( plot, painter, layout->titleRect() );
-    }
+        renderLayout.titleRect = layout->titleRect();
+        renderLayout.footerRect = layout->footerRect();
+        renderLayout.legendRect = layout->legendRect();
+        renderLayout.canvasRect = layout->canvasRect();
 
-    if ( !( d_data->discardFlags & DiscardFooter )
-        && ( !plot->footerLabel()->text().isEmpty() ) )
-    {
-        renderFooter( plot, painter, layout->footerRect() );
-    }
+        for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
+        {
+            renderLayout.scaleRect[axisId] = layout->scaleRect( axisId );
+            renderLayout.startDist[axisId] = renderLayout.endDist[axisId] = 0;
+            renderLayout.baseDist[axisId] = 0;
 
-    if ( !( d_data->discardFlags & DiscardLegend )
-        && plot->legend() && !plot->legend()->isEmpty() )
-    {
-        renderLegend( plot, painter, layout->legendRect() );
-    }
+            QwtScaleWidget *scaleWidget = plot->axisWidget( axisId );
+            if ( scaleWidget )
+            {
+                renderLayout.baseDist[axisId] = scaleWidget->margin();
+                scaleWidget->getBorderDistHint(
+                    renderLayout.startDist[axisId], renderLayout.endDist[axisId] );
+            }
+        }
 
-    for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
-    {
-        QwtScaleWidget *scaleWidget = plot->axisWidget( axisId );
-        if ( scaleWidget )
+        if ( d_data->cacheEnabled )
         {
-            int baseDist = scaleWidget->margin();
+            cache.invalidate();
 
-            int startDist, endDist;
-            scaleWidget->getBorderDistHint( startDist, endDist );
+            cache.plot = const_cast<QwtPlot *>( plot );
+            cache.rect = plotRect;
+            cache.dpiX = dpiX;
+            cache.dpiY = dpiY;
+            cache.renderHints = painter->renderHints();
 
-            renderScale( plot, painter, axisId, startDist, endDist,
-                baseDist, layout->scaleRect( axisId ) );
+            for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
+                cache.scaleDivs[axisId] = plot->axisScaleDiv( axisId );
+
+            cache.layout = renderLayout;
+            cache.isValid = true;
         }
     }
 
+    const bool useImage = d_data->cacheEnabled && qwtCanCacheImage( painter );
+
+    if ( useImage && cache.decorations.isNull() )
+    {
+        // pre-render the decorations into a transparent image,
+        // with the resolution of the paint device
+
+        const QRect r = plotRect.toAlignedRect();
+
+        QImage image( r.size(), QImage::Format_ARGB32_Premultiplied );
+        image.setDotsPerMeterX( qRound( dpiX / 0.0254 ) );
+        image.setDotsPerMeterY( qRound( dpiY / 0.0254 ) );
+        image.fill( Qt::transparent );
+
+        QPainter p( &image );
+        p.setRenderHints( painter->renderHints() );
+        p.translate( -r.topLeft() );
+        p.setWorldTransform( transform, true );
+
+        qwtRenderDecorations( this, plot, &p, renderLayout );
+
+        p.end();
+
+        cache.decorations = image;
+    }
+
+    // now start painting
+
+    painter->save();
+    painter->setWorldTransform( transform, true );
+
+    renderCanvas( plot, painter, renderLayout.canvasRect, renderLayout.maps );
+
+    if ( !useImage )
+        qwtRenderDecorations( this, plot, painter, renderLayout );
+
     painter->restore();
 
+    if ( useImage )
+        painter->drawImage( plotRect.toAlignedRect().topLeft(), cache.decorations );
+
     // restore all setting to their original attributes.
     for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
     {
@@ -812,7 +1391,8 @@ void QwtPlotRenderer::renderCanvas( const QwtPlot *plot,
         painter->save();
 
         painter->setClipRect( canvasRect );
-        plot->drawItems( painter, canvasRect, map );
+        qwtDrawItems( plot, painter, canvasRect, map,
+            d_data->vertexBudget, d_data->denseItemPolicy );
 
         painter->restore();
     }
@@ -836,7 +1416,8 @@ void QwtPlotRenderer::renderCanvas( const QwtPlot *plot,
         else
             painter->setClipPath( clipPath );
 
-        plot->drawItems( painter, canvasRect, map );
+        qwtDrawItems( plot, painter, canvasRect, map,
+            d_data->vertexBudget, d_data->denseItemPolicy );
 
         painter->restore();
     }
@@ -874,7 +1455,8 @@ void QwtPlotRenderer::renderCanvas( const QwtPlot *plot,
             QwtPainter::drawBackgound( painter, innerRect, canvas );
         }
 
-        plot->drawItems( painter, innerRect, map );
+        qwtDrawItems( plot, painter, innerRect, map,
+            d_data->vertexBudget, d_data->denseItemPolicy );
 
         painter->restore();
 
@@ -95,6 +95,27 @@ public:
     //! Layout flags
     typedef QFlags<LayoutFlag> LayoutFlags;
 
+    /*!
+       \brief Policy for items exceeding the vertex budget,
+              when rendering to a vector device
+       \sa setVertexBudget(), setDenseItemPolicy()
+     */
+    enum DenseItemPolicy
+    {
+        /*!
+          Weed out points, that are mapped to the same pixel.
+          When the weeded item is still above the budget it
+          is rasterized.
+         */
+        WeedDenseItems,
+
+        /*!
+          Render the item into an image with the resolution
+          of the paint device, that is embedded into the document.
+         */
+        RasterizeDenseItems
+    };
+
     explicit QwtPlotRenderer( QObject * = NULL );
     virtual ~QwtPlotRenderer();
 
@@ -110,6 +131,17 @@ public:
     void setLayoutFlags( LayoutFlags flags );
     LayoutFlags layoutFlags() const;
 
+    void setCacheEnabled( bool on );
+    bool isCacheEnabled() const;
+
+    void invalidateCache();
+
+    void setVertexBudget( int numVertices );
+    int vertexBudget() const;
+
+    void setDenseItemPolicy( DenseItemPolicy );
+    DenseItemPolicy denseItemPolicy() const;
+
     void renderDocument( QwtPlot *, const QString &fileName,
         const QSizeF &sizeMM, int resolution = 85 );
 
@@ -0,0 +1,1204 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_plot_scene.h"
+#include "qwt_plot_item.h"
+#include "qwt_scale_div.h"
+#include "qwt_scale_draw.h"
+#include "qwt_scale_engine.h"
+#include "qwt_transform.h"
+#include "qwt_math.h"
+#include <qpainter.h>
+#include <qpalette.h>
+#include <qtransform.h>
+#include <qapplication.h>
+#include <qdesktopwidget.h>
+#include <qthread.h>
+#include <qmutex.h>
+#include <qhash.h>
+#include <qfileinfo.h>
+#include <qimagewriter.h>
+
+#ifndef QWT_NO_SVG
+#ifdef QT_SVG_LIB
+#if QT_VERSION >= 0x040500
+#define QWT_FORMAT_SVG 1
+#endif
+#endif
+#endif
+
+#ifndef QT_NO_PRINTER
+#define QWT_FORMAT_PDF 1
+#endif
+
+#ifndef QT_NO_PDF
+#if QT_VERSION >= 0x050300
+
+#ifndef QWT_FORMAT_PDF
+#define QWT_FORMAT_PDF 1
+#endif
+
+#define QWT_PDF_WRITER 1
+
+#endif
+#endif
+
+#if QWT_FORMAT_SVG
+#include <qsvggenerator.h>
+#endif
+
+#if QWT_PDF_WRITER
+#include <qpdfwriter.h>
+#else
+#ifndef QT_NO_PRINTER
+#include <qprinter.h>
+#endif
+#endif
+
+// distance between the backbone of a scale and its title
+static const int qwtScaleTitleSpacing = 2;
+
+// limit for the number of layouts in the process wide cache
+static const int qwtMaxCachedLayouts = 1000;
+
+class QwtSceneLayout
+{
+public:
+    void translate( const QPointF &offset )
+    {
+        titleRect.translate( offset );
+        footerRect.translate( offset );
+        canvasRect.translate( offset );
+
+        for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
+            scaleRect[axisId].translate( offset );
+    }
+
+    QRectF titleRect;
+    QRectF footerRect;
+    QRectF canvasRect;
+    QRectF scaleRect[QwtPlot::axisCnt];
+};
+
+class QwtSceneLayoutCache
+{
+public:
+    bool find( const QString &key, QwtSceneLayout &layout )
+    {
+        QMutexLocker locker( &mutex );
+
+        QHash<QString, QwtSceneLayout>::const_iterator it = layouts.constFind( key );
+        if ( it == layouts.constEnd() )
+            return false;
+
+        layout = it.value();
+        return true;
+    }
+
+    void insert( const QString &key, const QwtSceneLayout &layout )
+    {
+        QMutexLocker locker( &mutex );
+
+        // scenes with varying scales would let the cache grow forever
+        if ( layouts.size() >= qwtMaxCachedLayouts )
+            layouts.clear();
+
+        layouts.insert( key, layout );
+    }
+
+    void clear()
+    {
+        QMutexLocker locker( &mutex );
+        layouts.clear();
+    }
+
+private:
+    QMutex mutex;
+    QHash<QString, QwtSceneLayout> layouts;
+};
+
+static QwtSceneLayoutCache qwtSceneLayoutCache;
+
+static QMutex qwtResolutionMutex;
+static QSize qwtResolution;
+
+static QSize qwtLayoutResolution()
+{
+    // Text is measured by QwtText with the metrics of the screen,
+    // so we have to calculate the layout in screen coordinates.
+
+    QMutexLocker locker( &qwtResolutionMutex );
+
+    if ( !qwtResolution.isValid() )
+    {
+        // QApplication::desktop() must not be called from other threads
+
+        if ( qApp == NULL || QThread::currentThread() != qApp->thread() )
+            return QSize( 96, 96 );
+
+        QSize res( 96, 96 );
+
+        QDesktopWidget *desktop = QApplication::desktop();
+        if ( desktop )
+            res = QSize( desktop->logicalDpiX(), desktop->logicalDpiY() );
+
+        qwtResolution = res;
+    }
+
+    return qwtResolution;
+}
+
+static inline bool qwtIsXAxis( int axisId )
+{
+    return axisId == QwtPlot::xBottom || axisId == QwtPlot::xTop;
+}
+
+static QwtScaleDraw::Alignment qwtScaleAlignment( int axisId )
+{
+    switch( axisId )
+    {
+        case QwtPlot::yLeft:
+            return QwtScaleDraw::LeftScale;
+        case QwtPlot::yRight:
+            return QwtScaleDraw::RightScale;
+        case QwtPlot::xTop:
+            return QwtScaleDraw::TopScale;
+        default:
+            return QwtScaleDraw::BottomScale;
+    }
+}
+
+static QwtSceneLayout qwtCalculateLayout(
+    const QwtPlotScene *scene, const QRectF &rect )
+{
+    QwtSceneLayout layout;
+
+    QRectF r = rect;
+    const int spacing = scene->spacing();
+
+    const QwtText title = scene->title();
+    if ( !title.isEmpty() )
+    {
+        const double h = qCeil( title.heightForWidth( r.width() ) );
+
+        layout.titleRect = QRectF( r.left(), r.top(), r.width(), h );
+        r.setTop( r.top() + h + spacing );
+    }
+
+    const QwtText footer = scene->footer();
+    if ( !footer.isEmpty() )
+    {
+        const double h = qCeil( footer.heightForWidth( r.width() ) );
+
+        layout.footerRect = QRectF( r.left(), r.bottom() - h, r.width(), h );
+        r.setBottom( r.bottom() - h - spacing );
+    }
+
+    double dim[QwtPlot::axisCnt];
+    int startDist[QwtPlot::axisCnt];
+    int endDist[QwtPlot::axisCnt];
+
+    for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
+    {
+        dim[axisId] = 0.0;
+        startDist[axisId] = endDist[axisId] = 0;
+
+        if ( !scene->axisEnabled( axisId ) )
+            continue;
+
+        const QFont font = scene->axisFont( axisId );
+        const QwtScaleDraw *scaleDraw = scene->axisScaleDraw( axisId );
+
+        dim[axisId] = qCeil( scaleDraw->extent( font ) ) + 1;
+
+        const QwtText axisTitle = scene->axisTitle( axisId );
+        if ( !axisTitle.isEmpty() )
+        {
+            const double length = qwtIsXAxis( axisId ) ? r.width() : r.height();
+            dim[axisId] += qCeil( axisTitle.heightForWidth( length, font ) )
+                + qwtScaleTitleSpacing;
+        }
+
+        scaleDraw->getBorderDistHint( font, startDist[axisId], endDist[axisId] );
+    }
+
+    double left = r.left() + dim[QwtPlot::yLeft];
+    double right = r.right() - dim[QwtPlot::yRight];
+    double top = r.top() + dim[QwtPlot::xTop];
+    double bottom = r.bottom() - dim[QwtPlot::xBottom];
+
+    // leave space for the labels at the ends of the scales
+
+    left = qMax( left, r.left() +
+        qMax( startDist[QwtPlot::xBottom], startDist[QwtPlot::xTop] ) );
+    right = qMin( right, r.right() -
+        qMax( endDist[QwtPlot::xBottom], endDist[QwtPlot::xTop] ) );
+    top = qMax( top, r.top() +
+        qMax( startDist[QwtPlot::yLeft], startDist[QwtPlot::yRight] ) );
+    bottom = qMin( bottom, r.bottom() -
+        qMax( endDist[QwtPlot::yLeft], endDist[QwtPlot::yRight] ) );
+
+    const QRectF canvasRect( left, top,
+        qMax( right - left, 0.0 ), qMax( bottom - top, 0.0 ) );
+
+    layout.canvasRect = canvasRect;
+
+    layout.scaleRect[QwtPlot::yLeft] = QRectF(
+        canvasRect.left() - dim[QwtPlot::yLeft], canvasRect.top(),
+        dim[QwtPlot::yLeft], canvasRect.height() );
+
+    layout.scaleRect[QwtPlot::yRight] = QRectF(
+        canvasRect.right(), canvasRect.top(),
+        dim[QwtPlot::yRight], canvasRect.height() );
+
+    layout.scaleRect[QwtPlot::xTop] = QRectF(
+        canvasRect.left(), canvasRect.top() - dim[QwtPlot::xTop],
+        canvasRect.width(), dim[QwtPlot::xTop] );
+
+    layout.scaleRect[QwtPlot::xBottom] = QRectF(
+        canvasRect.left(), canvasRect.bottom(),
+        canvasRect.width(), dim[QwtPlot::xBottom] );
+
+    return layout;
+}
+
+static QwtSceneLayout qwtSceneLayout(
+    const QwtPlotScene *scene, const QRectF &rect )
+{
+    // the layout is calculated for a rectangle at ( 0, 0 ), so that
+    // it can be shared between different target positions
+
+    const QRectF layoutRect( 0.0, 0.0, rect.width(), rect.height() );
+
+    QwtSceneLayout layout;
+
+    const QString key = scene->layoutKey();
+    if ( key.isEmpty() )
+    {
+        layout = qwtCalculateLayout( scene, layoutRect );
+    }
+    else
+    {
+        // the resolution differs, when the first layout has been
+        // calculated before the screen metrics were available
+
+        const QSize res = qwtLayoutResolution();
+
+        QString cacheKey = QString( "%1:%2x%3:%4x%5" ).arg( key )
+            .arg( rect.width(), 0, 'f', 2 ).arg( rect.height(), 0, 'f', 2 )
+            .arg( res.width() ).arg( res.height() );
+
+        // the tick labels depend on the scale bounds and fonts
+
+        for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
+        {
+            if ( !scene->axisEnabled( axisId ) )
+                continue;
+
+            const QwtScaleDiv &scaleDiv = scene->axisScaleDiv( axisId );
+
+            cacheKey += QString( ":%1:%2:%3:%4" ).arg( axisId )
+                .arg( scaleDiv.lowerBound(), 0, 'g', 17 )
+                .arg( scaleDiv.upperBound(), 0, 'g', 17 )
+                .arg( scene->axisFont( axisId ).toString() );
+        }
+
+        if ( !qwtSceneLayoutCache.find( cacheKey, layout ) )
+        {
+            layout = qwtCalculateLayout( scene, layoutRect );
+            qwtSceneLayoutCache.insert( cacheKey, layout );
+        }
+    }
+
+    layout.translate( rect.topLeft() );
+    return layout;
+}
+
+class QwtPlotScene::PrivateData
+{
+public:
+    class AxisData
+    {
+    public:
+        bool isEnabled;
+        QwtScaleDiv scaleDiv;
+        QwtTransform *transform;
+        QwtScaleDraw *scaleDraw;
+        QwtText title;
+        QFont font;
+    };
+
+    PrivateData():
+        background( Qt::white ),
+        canvasBackground( Qt::white ),
+        spacing( 5 )
+    {
+    }
+
+    ~PrivateData()
+    {
+        for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
+        {
+            delete axisData[axisId].transform;
+            delete axisData[axisId].scaleDraw;
+        }
+    }
+
+    QString layoutKey;
+
+    QwtText title;
+    QwtText footer;
+
+    QBrush background;
+    QBrush canvasBackground;
+
+    int spacing;
+
+    AxisData axisData[QwtPlot::axisCnt];
+};
+
+/*!
+  \brief Constructor
+
+  The scene is initialized with enabled QwtPlot::yLeft and
+  QwtPlot::xBottom axes, showing linear scales from 0 to 1000.
+ */
+QwtPlotScene::QwtPlotScene()
+{
+    d_data = new PrivateData;
+
+    // initializing the screen metrics, when we are in the GUI thread
+    ( void ) qwtLayoutResolution();
+
+    const QwtScaleDiv scaleDiv =
+        QwtLinearScaleEngine().divideScale( 0.0, 1000.0, 8, 5 );
+
+    for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
+    {
+        PrivateData::AxisData &d = d_data->axisData[axisId];
+
+        d.isEnabled = ( axisId == QwtPlot::yLeft || axisId == QwtPlot::xBottom );
+        d.scaleDiv = scaleDiv;
+        d.transform = NULL;
+        d.font = QFont( d.font.family(), 10 );
+
+        QFont titleFont( d.font.family(), 12, QFont::Bold );
+        d.title.setFont( titleFont );
+
+        d.scaleDraw = new QwtScaleDraw();
+        d.scaleDraw->setAlignment( qwtScaleAlignment( axisId ) );
+        d.scaleDraw->setScaleDiv( scaleDiv );
+    }
+
+    d_data->title.setRenderFlags( Qt::AlignCenter | Qt::TextWordWrap );
+    d_data->title.setFont( QFont( QFont().family(), 14, QFont::Bold ) );
+
+    d_data->footer.setRenderFlags( Qt::AlignCenter | Qt::TextWordWrap );
+}
+
+//! Destructor, deleting all items, when autoDelete() is enabled
+QwtPlotScene::~QwtPlotScene()
+{
+    delete d_data;
+}
+
+/*!
+  \brief Insert an item into the scene
+
+  In opposite to QwtPlotItem::attach() the item doesn't know
+  about the scene. When autoDelete() is enabled the scene takes
+  ownership of the item.
+
+  \param item Plot item
+  \sa detachItem()
+ */
+void QwtPlotScene::attachItem( QwtPlotItem *item )
+{
+    if ( item && !itemList().contains( item ) )
+        insertItem( item );
+}
+
+/*!
+  \brief Remove an item from the scene
+  \param item Plot item
+  \sa attachItem()
+ */
+void QwtPlotScene::detachItem( QwtPlotItem *item )
+{
+    if ( item )
+        removeItem( item );
+}
+
+/*!
+  \brief Assign a key for sharing layout calculations
+
+  Scenes with the same key need to have the same title, footer and
+  scale draws. For them the geometry of the decorations for a specific size,
+  scale bounds and axis fonts is calculated only once and shared
+  between all scenes - even when they are rendered in different threads.
+
+  The default setting is an empty key, what disables the cache.
+
+  \param key Layout key
+  \sa layoutKey(), clearLayoutCache()
+ */
+void QwtPlotScene::setLayoutKey( const QString &key )
+{
+    d_data->layoutKey = key;
+}
+
+/*!
+  \return Key for sharing layout calculations
+  \sa setLayoutKey()
+ */
+QString QwtPlotScene::layoutKey() const
+{
+    return d_data->layoutKey;
+}
+
+/*!
+  \brief Remove all layouts from the process wide cache
+
+  Needs to be called, when the decorations of scenes with
+  a layoutKey() have been modified.
+
+  \sa setLayoutKey()
+ */
+void QwtPlotScene::clearLayoutCache()
+{
+    qwtSceneLayoutCache.clear();
+}
+
+/*!
+  Set the title
+  \param title Title
+  \sa title()
+ */
+void QwtPlotScene::setTitle( const QwtText &title )
+{
+    d_data->title = title;
+}
+
+/*!
+  \return Title
+  \sa setTitle()
+ */
+QwtText QwtPlotScene::title() const
+{
+    return d_data->title;
+}
+
+/*!
+  Set the footer
+  \param footer Footer
+  \sa footer()
+ */
+void QwtPlotScene::setFooter( const QwtText &footer )
+{
+    d_data->footer = footer;
+}
+
+/*!
+  \return Footer
+  \sa setFooter()
+ */
+QwtText QwtPlotScene::footer() const
+{
+    return d_data->footer;
+}
+
+/*!
+  Set the brush for filling the complete target rectangle
+  \param brush Background brush, Qt::NoBrush for a transparent background
+  \sa background(), setCanvasBackground()
+ */
+void QwtPlotScene::setBackground( const QBrush &brush )
+{
+    d_data->background = brush;
+}
+
+/*!
+  \return Background brush
+  \sa setBackground()
+ */
+QBrush QwtPlotScene::background() const
+{
+    return d_data->background;
+}
+
+/*!
+  Set the brush for filling the canvas
+  \param brush Canvas background brush
+  \sa canvasBackground(), setBackground()
+ */
+void QwtPlotScene::setCanvasBackground( const QBrush &brush )
+{
+    d_data->canvasBackground = brush;
+}
+
+/*!
+  \return Canvas background brush
+  \sa setCanvasBackground()
+ */
+QBrush QwtPlotScene::canvasBackground() const
+{
+    return d_data->canvasBackground;
+}
+
+/*!
+  Set the spacing between title, footer and the scales
+  \param spacing Spacing
+  \sa spacing()
+ */
+void QwtPlotScene::setSpacing( int spacing )
+{
+    d_data->spacing = qMax( spacing, 0 );
+}
+
+/*!
+  \return Spacing between title, footer and the scales
+  \sa setSpacing()
+ */
+int QwtPlotScene::spacing() const
+{
+    return d_data->spacing;
+}
+
+/*!
+  Enable or disable an axis
+  \param axisId Axis index
+  \param on On/Off
+  \sa axisEnabled()
+ */
+void QwtPlotScene::enableAxis( int axisId, bool on )
+{
+    if ( axisId >= 0 && axisId < QwtPlot::axisCnt )
+        d_data->axisData[axisId].isEnabled = on;
+}
+
+/*!
+  \return True, when the axis is enabled
+  \param axisId Axis index
+ */
+bool QwtPlotScene::axisEnabled( int axisId ) const
+{
+    if ( axisId >= 0 && axisId < QwtPlot::axisCnt )
+        return d_data->axisData[axisId].isEnabled;
+
+    return false;
+}
+
+/*!
+  Assign a scale division
+
+  \param axisId Axis index
+  \param scaleDiv Scale division
+  \sa axisScaleDiv(), QwtScaleEngine::divideScale()
+ */
+void QwtPlotScene::setAxisScaleDiv( int axisId, const QwtScaleDiv &scaleDiv )
+{
+    if ( axisId >= 0 && axisId < QwtPlot::axisCnt )
+    {
+        PrivateData::AxisData &d = d_data->axisData[axisId];
+
+        d.scaleDiv = scaleDiv;
+        d.scaleDraw->setScaleDiv( scaleDiv );
+    }
+}
+
+/*!
+  \return Scale division of an axis
+  \param axisId Axis index
+ */
+const QwtScaleDiv &QwtPlotScene::axisScaleDiv( int axisId ) const
+{
+    return d_data->axisData[axisId].scaleDiv;
+}
+
+/*!
+  Assign a transformation
+
+  \param axisId Axis index
+  \param transform Transformation, NULL for a linear scale.
+                   The scene takes ownership of the transformation.
+
+  \sa axisTransformation()
+ */
+void QwtPlotScene::setAxisTransformation(
+    int axisId, QwtTransform *transform )
+{
+    if ( axisId < 0 || axisId >= QwtPlot::axisCnt )
+    {
+        delete transform;
+        return;
+    }
+
+    PrivateData::AxisData &d = d_data->axisData[axisId];
+
+    if ( transform != d.transform )
+    {
+        delete d.transform;
+        d.transform = transform;
+    }
+
+    d.scaleDraw->setTransformation( transform ? transform->copy() : NULL );
+}
+
+/*!
+  \return Transformation of an axis, NULL for a linear scale
+  \param axisId Axis index
+ */
+const QwtTransform *QwtPlotScene::axisTransformation( int axisId ) const
+{
+    if ( axisId >= 0 && axisId < QwtPlot::axisCnt )
+        return d_data->axisData[axisId].transform;
+
+    return NULL;
+}
+
+/*!
+  Assign a scale draw
+
+  \param axisId Axis index
+  \param scaleDraw Scale draw. The scene takes ownership of it.
+ */
+void QwtPlotScene::setAxisScaleDraw( int axisId, QwtScaleDraw *scaleDraw )
+{
+    if ( scaleDraw == NULL )
+        return;
+
+    if ( axisId < 0 || axisId >= QwtPlot::axisCnt )
+    {
+        delete scaleDraw;
+        return;
+    }
+
+    PrivateData::AxisData &d = d_data->axisData[axisId];
+
+    if ( scaleDraw != d.scaleDraw )
+    {
+        delete d.scaleDraw;
+        d.scaleDraw = scaleDraw;
+    }
+
+    d.scaleDraw->setAlignment( qwtScaleAlignment( axisId ) );
+    d.scaleDraw->setScaleDiv( d.scaleDiv );
+    d.scaleDraw->setTransformation(
+        d.transform ? d.transform->copy() : NULL );
+}
+
+/*!
+  \return Scale draw of an axis
+  \param axisId Axis index
+ */
+const QwtScaleDraw *QwtPlotScene::axisScaleDraw( int axisId ) const
+{
+    if ( axisId >= 0 && axisId < QwtPlot::axisCnt )
+        return d_data->axisData[axisId].scaleDraw;
+
+    return NULL;
+}
+
+/*!
+  \return Scale draw of an axis
+  \param axisId Axis index
+ */
+QwtScaleDraw *QwtPlotScene::axisScaleDraw( int axisId )
+{
+    if ( axisId >= 0 && axisId < QwtPlot::axisCnt )
+        return d_data->axisData[axisId].scaleDraw;
+
+    return NULL;
+}
+
+/*!
+  Set the title of an axis
+  \param axisId Axis index
+  \param title Title
+ */
+void QwtPlotScene::setAxisTitle( int axisId, const QwtText &title )
+{
+    if ( axisId >= 0 && axisId < QwtPlot::axisCnt )
+        d_data->axisData[axisId].title = title;
+}
+
+/*!
+  \return Title of an axis
+  \param axisId Axis index
+ */
+QwtText QwtPlotScene::axisTitle( int axisId ) const
+{
+    if ( axisId >= 0 && axisId < QwtPlot::axisCnt )
+        return d_data->axisData[axisId].title;
+
+    return QwtText();
+}
+
+/*!
+  Set the font of the tick labels of an axis
+  \param axisId Axis index
+  \param font Font
+ */
+void QwtPlotScene::setAxisFont( int axisId, const QFont &font )
+{
+    if ( axisId >= 0 && axisId < QwtPlot::axisCnt )
+        d_data->axisData[axisId].font = font;
+}
+
+/*!
+  \return Font of the tick labels of an axis
+  \param axisId Axis index
+ */
+QFont QwtPlotScene::axisFont( int axisId ) const
+{
+    if ( axisId >= 0 && axisId < QwtPlot::axisCnt )
+        return d_data->axisData[axisId].font;
+
+    return QFont();
+}
+
+/*!
+  \brief Calculate the canvas rectangle for rendering the scene
+
+  \param rect Target rectangle
+  \param paintDevice Paint device
+
+  \return Canvas rectangle in coordinates of the layout, that
+          are in the resolution of the screen
+ */
+QRectF QwtPlotScene::canvasRect( const QRectF &rect,
+    const QPaintDevice *paintDevice ) const
+{
+    const QSize res = qwtLayoutResolution();
+
+    QTransform transform;
+    if ( paintDevice )
+    {
+        transform.scale(
+            double( paintDevice->logicalDpiX() ) / res.width(),
+            double( paintDevice->logicalDpiY() ) / res.height() );
+    }
+
+    const QRectF layoutRect = transform.inverted().mapRect( rect );
+    return qwtSceneLayout( this, layoutRect ).canvasRect;
+}
+
+/*!
+  \brief Render the scene into a rectangle
+
+  Before painting, QwtPlotItem::updateScaleDiv() is called for all items
+  with the QwtPlotItem::ScaleInterest, like QwtPlot does, when its
+  scales have changed.
+
+  \param painter Painter
+  \param rect Target rectangle
+ */
+void QwtPlotScene::render( QPainter *painter, const QRectF &rect ) const
+{
+    if ( painter == NULL || !painter->isActive() || !rect.isValid() )
+        return;
+
+    if ( d_data->background.style() != Qt::NoBrush )
+        painter->fillRect( rect, d_data->background );
+
+    /*
+      As in QwtPlotRenderer the layout is calculated in
+      screen coordinates and painted with a scaled painter.
+     */
+    const QSize res = qwtLayoutResolution();
+
+    QTransform transform;
+    transform.scale(
+        double( painter->device()->logicalDpiX() ) / res.width(),
+        double( painter->device()->logicalDpiY() ) / res.height() );
+
+    const QRectF layoutRect = transform.inverted().mapRect( rect );
+    const QwtSceneLayout layout = qwtSceneLayout( this, layoutRect );
+
+    const QRectF &canvasRect = layout.canvasRect;
+
+    QwtScaleMap maps[QwtPlot::axisCnt];
+    for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
+    {
+        const PrivateData::AxisData &d = d_data->axisData[axisId];
+
+        QwtScaleMap &map = maps[axisId];
+        map.setTransformation( d.transform ? d.transform->copy() : NULL );
+        map.setScaleInterval( d.scaleDiv.lowerBound(), d.scaleDiv.upperBound() );
+
+        if ( qwtIsXAxis( axisId ) )
+            map.setPaintInterval( canvasRect.left(), canvasRect.right() );
+        else
+            map.setPaintInterval( canvasRect.bottom(), canvasRect.top() );
+    }
+
+    painter->save();
+    painter->setWorldTransform( transform, true );
+
+    // canvas
+
+    painter->save();
+
+    if ( d_data->canvasBackground.style() != Qt::NoBrush )
+        painter->fillRect( canvasRect, d_data->canvasBackground );
+
+    painter->setClipRect( canvasRect );
+
+    // like QwtPlot::updateAxes() for items, that depend on the scales
+
+    const QwtPlotItemList& itmList = itemList();
+    for ( QwtPlotItemIterator it = itmList.begin();
+        it != itmList.end(); ++it )
+    {
+        QwtPlotItem *item = *it;
+        if ( item && item->testItemInterest( QwtPlotItem::ScaleInterest ) )
+        {
+            item->updateScaleDiv( axisScaleDiv( item->xAxis() ),
+                axisScaleDiv( item->yAxis() ) );
+        }
+    }
+
+    drawItems( painter, canvasRect, maps );
+
+    painter->restore();
+
+    // decorations
+
+    const QPalette palette;
+
+    if ( !d_data->title.isEmpty() )
+    {
+        painter->save();
+        painter->setPen( palette.color( QPalette::Active, QPalette::Text ) );
+        d_data->title.draw( painter, layout.titleRect );
+        painter->restore();
+    }
+
+    if ( !d_data->footer.isEmpty() )
+    {
+        painter->save();
+        painter->setPen( palette.color( QPalette::Active, QPalette::Text ) );
+        d_data->footer.draw( painter, layout.footerRect );
+        painter->restore();
+    }
+
+    for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
+    {
+        if ( d_data->axisData[axisId].isEnabled )
+            drawScale( painter, axisId, layout.scaleRect[axisId], canvasRect );
+    }
+
+    painter->restore();
+}
+
+/*!
+  \brief Render the scene to a paint device
+
+  The target rectangle is derived from the metrics of the device.
+
+  \param paintDevice Paint device, f.e a QImage
+ */
+void QwtPlotScene::renderTo( QPaintDevice &paintDevice ) const
+{
+    QPainter painter( &paintDevice );
+    render( &painter, QRectF( 0, 0,
+        paintDevice.width(), paintDevice.height() ) );
+}
+
+/*!
+  \brief Render the scene to an image
+
+  \param size Size of the image
+  \param resolution Resolution in dots per inch
+  \param format Image format
+
+  \return Image with the rendered scene
+ */
+QImage QwtPlotScene::toImage( const QSize &size,
+    int resolution, QImage::Format format ) const
+{
+    QImage image( size, format );
+    if ( image.isNull() )
+        return image;
+
+    if ( resolution > 0 )
+    {
+        const double mmToInch = 1.0 / 25.4;
+        const int dotsPerMeter = qRound( resolution * mmToInch * 1000.0 );
+
+        image.setDotsPerMeterX( dotsPerMeter );
+        image.setDotsPerMeterY( dotsPerMeter );
+    }
+
+    image.fill( Qt::transparent );
+    renderTo( image );
+
+    return image;
+}
+
+/*!
+  Render the scene to a file
+
+  The format of the document will be auto-detected from the
+  suffix of the file name.
+
+  \param fileName Path of the file, where the document will be stored
+  \param sizeMM Size for the document in millimeters.
+  \param resolution Resolution in dots per Inch (dpi)
+
+  \return true, when the document has been written
+*/
+bool QwtPlotScene::renderDocument( const QString &fileName,
+    const QSizeF &sizeMM, int resolution ) const
+{
+    return renderDocument( fileName,
+        QFileInfo( fileName ).suffix(), sizeMM, resolution );
+}
+
+/*!
+  Render the scene to a file
+
+  Supported formats are pdf, svg and all image formats
+  supported by QImageWriter.
+
+  \param fileName Path of the file, where the document will be stored
+  \param format Format for the document
+  \param sizeMM Size for the document in millimeters.
+  \param resolution Resolution in dots per Inch (dpi)
+
+  \return true, when the document has been written
+  \sa QwtPlotRenderer::renderDocument()
+*/
+bool QwtPlotScene::renderDocument( const QString &fileName,
+    const QString &format, const QSizeF &sizeMM, int resolution ) const
+{
+    if ( sizeMM.isEmpty() || resolution <= 0 )
+        return false;
+
+    QString title = d_data->title.text();
+    if ( title.isEmpty() )
+        title = "Plot Document";
+
+    const double mmToInch = 1.0 / 25.4;
+    const QSizeF size = sizeMM * mmToInch * resolution;
+
+    const QRectF documentRect( 0.0, 0.0, size.width(), size.height() );
+
+    const QString fmt = format.toLower();
+    if ( fmt == "pdf" )
+    {
+#if QWT_FORMAT_PDF
+
+#if QWT_PDF_WRITER
+        QPdfWriter pdfWriter( fileName );
+        pdfWriter.setPageSizeMM( sizeMM );
+        pdfWriter.setTitle( title );
+        pdfWriter.setPageMargins( QMarginsF() );
+        pdfWriter.setResolution( resolution );
+
+        QPainter painter( &pdfWriter );
+        render( &painter, documentRect );
+#else
+        QPrinter printer;
+        printer.setOutputFormat( QPrinter::PdfFormat );
+        printer.setColorMode( QPrinter::Color );
+        printer.setFullPage( true );
+        printer.setPaperSize( sizeMM, QPrinter::Millimeter );
+        printer.setDocName( title );
+        printer.setOutputFileName( fileName );
+        printer.setResolution( resolution );
+
+        QPainter painter( &printer );
+        render( &painter, documentRect );
+#endif
+        return true;
+#endif
+    }
+    else if ( fmt == "svg" )
+    {
+#if QWT_FORMAT_SVG
+        QSvgGenerator generator;
+        generator.setTitle( title );
+        generator.setFileName( fileName );
+        generator.setResolution( resolution );
+        generator.setViewBox( documentRect );
+
+        QPainter painter( &generator );
+        render( &painter, documentRect );
+
+        return true;
+#endif
+    }
+    else
+    {
+        if ( QImageWriter::supportedImageFormats().indexOf(
+            format.toLatin1() ) >= 0 )
+        {
+            QImage image = toImage( documentRect.toRect().size(), resolution );
+            return image.save( fileName, format.toLatin1() );
+        }
+    }
+
+    return false;
+}
+
+/*!
+  Draw the items of the scene
+
+  \param painter Painter
+  \param canvasRect Bounding rectangle where to paint
+  \param maps QwtPlot::axisCnt maps, mapping between plot and
+              paint device coordinates
+
+  \sa QwtPlot::drawItems()
+ */
+void QwtPlotScene::drawItems( QPainter *painter, const QRectF &canvasRect,
+    const QwtScaleMap maps[QwtPlot::axisCnt] ) const
+{
+    const QwtPlotItemList& itmList = itemList();
+    for ( QwtPlotItemIterator it = itmList.begin();
+        it != itmList.end(); ++it )
+    {
+        const QwtPlotItem *item = *it;
+        if ( item && item->isVisible() )
+        {
+            painter->save();
+
+            painter->setRenderHint( QPainter::Antialiasing,
+                item->testRenderHint( QwtPlotItem::RenderAntialiased ) );
+            painter->setRenderHint( QPainter::HighQualityAntialiasing,
+                item->testRenderHint( QwtPlotItem::RenderAntialiased ) );
+
+            item->draw( painter,
+                maps[item->xAxis()], maps[item->yAxis()],
+                canvasRect );
+
+            painter->restore();
+        }
+    }
+}
+
+/*!
+  Draw a scale and its title
+
+  \param painter Painter
+  \param axisId Axis index
+  \param scaleRect Bounding rectangle of the scale
+  \param canvasRect Bounding rectangle of the canvas
+
+  \sa QwtPlotRenderer::renderScale()
+ */
+void QwtPlotScene::drawScale( QPainter *painter, int axisId,
+    const QRectF &scaleRect, const QRectF &canvasRect ) const
+{
+    const PrivateData::AxisData &d = d_data->axisData[axisId];
+    const QPalette palette;
+
+    double x, y, length;
+    switch( axisId )
+    {
+        case QwtPlot::yLeft:
+        {
+            x = scaleRect.right() - 1.0;
+            y = canvasRect.top();
+            length = canvasRect.height();
+            break;
+        }
+        case QwtPlot::yRight:
+        {
+            x = scaleRect.left();
+            y = canvasRect.top();
+            length = canvasRect.height();
+            break;
+        }
+        case QwtPlot::xTop:
+        {
+            x = canvasRect.left();
+            y = scaleRect.bottom() - 1.0;
+            length = canvasRect.width();
+            break;
+        }
+        case QwtPlot::xBottom:
+        default:
+        {
+            x = canvasRect.left();
+            y = scaleRect.top();
+            length = canvasRect.width();
+        }
+    }
+
+    painter->save();
+    painter->setFont( d.font );
+
+    /*
+      Painting with the scale draw of the scene, so that its labels
+      remain cached. Its geometry is restored afterwards, as the
+      layout calculation must not depend on a previous rendering.
+     */
+
+    QwtScaleDraw *scaleDraw = d.scaleDraw;
+
+    const QPointF pos = scaleDraw->pos();
+    const double len = scaleDraw->length();
+
+    scaleDraw->move( x, y );
+    scaleDraw->setLength( length );
+    scaleDraw->draw( painter, palette );
+
+    scaleDraw->move( pos );
+    scaleDraw->setLength( len );
+
+    painter->restore();
+
+    if ( d.title.isEmpty() )
+        return;
+
+    QRectF r = scaleRect;
+    double angle = 0.0;
+    int flags = d.title.renderFlags() &
+        ~( Qt::AlignTop | Qt::AlignBottom | Qt::AlignVCenter );
+
+    switch ( axisId )
+    {
+        case QwtPlot::yLeft:
+            angle = -90.0;
+            flags |= Qt::AlignTop;
+            r.setRect( r.left(), r.bottom(), r.height(), r.width() );
+            break;
+
+        case QwtPlot::yRight:
+            angle = -90.0;
+            flags |= Qt::AlignBottom;
+            r.setRect( r.left(), r.bottom(), r.height(), r.width() );
+            break;
+
+        case QwtPlot::xTop:
+            flags |= Qt::AlignTop;
+            break;
+
+        case QwtPlot::xBottom:
+        default:
+            flags |= Qt::AlignBottom;
+            break;
+    }
+
+    painter->save();
+    painter->setFont( d.font );
+    painter->setPen( palette.color( QPalette::Active, QPalette::Text ) );
+
+    painter->translate( r.x(), r.y() );
+    if ( angle != 0.0 )
+        painter->rotate( angle );
+
+    QwtText title = d.title;
+    title.setRenderFlags( flags );
+    title.draw( painter, QRectF( 0.0, 0.0, r.width(), r.height() ) );
+
+    painter->restore();
+}
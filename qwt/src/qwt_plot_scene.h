@@ -0,0 +1,165 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_PLOT_SCENE_H
+#define QWT_PLOT_SCENE_H
+
+#include "qwt_global.h"
+#include "qwt_plot.h"
+#include "qwt_plot_dict.h"
+#include "qwt_scale_map.h"
+#include "qwt_text.h"
+#include <qbrush.h>
+#include <qfont.h>
+#include <qimage.h>
+#include <qstring.h>
+
+class QPainter;
+class QPaintDevice;
+class QwtScaleDiv;
+class QwtScaleDraw;
+class QwtTransform;
+
+/*!
+  \brief A widget free description of a plot, that can be rendered
+         from any thread
+
+  QwtPlotScene holds everything, that is needed to render a plot
+  without having a QwtPlot widget: a title, a footer, up to four scales
+  and the plot items. In opposite to QwtPlot no scales are calculated
+  from the items - the scale divisions have to be assigned explicitly.
+
+  As QwtPlotScene does not depend on any widget it can be rendered
+  by worker threads. F.e. for exporting thousands of documents
+  it is possible to have one scene per thread using a headless platform
+  plugin like "offscreen".
+
+  The geometry of the decorations ( title, footer, scales ) is expensive
+  to calculate as it needs to measure all tick labels. Scenes, that share
+  the same decorations can share their layout calculations by assigning
+  the same layoutKey(). The layouts are stored in a process wide cache,
+  that is protected for concurrent access.
+
+  \par Example
+  \verbatim
+#include <qwt_plot_scene.h>
+#include <qwt_plot_curve.h>
+
+class ReportTask: public QRunnable
+{
+    virtual void run()
+    {
+        QwtPlotScene scene;
+        scene.setLayoutKey( "report" );
+        scene.setTitle( "Report" );
+        scene.setAxisScaleDiv( QwtPlot::xBottom, xDiv );
+        scene.setAxisScaleDiv( QwtPlot::yLeft, yDiv );
+
+        QwtPlotCurve *curve = new QwtPlotCurve();
+        curve->setSamples( samples );
+        scene.attachItem( curve );
+
+        scene.renderDocument( fileName, QSizeF( 300, 200 ), 85 );
+    }
+};
+\endverbatim
+
+  \note Tick labels are measured with the fonts of the screen. So
+        QApplication has to be instantiated, before rendering a scene.
+        The resolution of the screen is read, when a scene is created
+        in the GUI thread. Before, a resolution of 96 dpi is assumed.
+  \note Rendering adjusts the scale draws and items of the scene. So
+        different threads can render different scenes, but one scene
+        must not be rendered by several threads at the same time.
+  \note Items attached to a scene have no plot() - items like
+        QwtPlotLegendItem, that depend on a QwtPlot are not supported.
+
+  \sa QwtPlotRenderer
+*/
+class QWT_EXPORT QwtPlotScene: public QwtPlotDict
+{
+public:
+    QwtPlotScene();
+    virtual ~QwtPlotScene();
+
+    void attachItem( QwtPlotItem * );
+    void detachItem( QwtPlotItem * );
+
+    void setLayoutKey( const QString & );
+    QString layoutKey() const;
+
+    static void clearLayoutCache();
+
+    void setTitle( const QwtText & );
+    QwtText title() const;
+
+    void setFooter( const QwtText & );
+    QwtText footer() const;
+
+    void setBackground( const QBrush & );
+    QBrush background() const;
+
+    void setCanvasBackground( const QBrush & );
+    QBrush canvasBackground() const;
+
+    void setSpacing( int );
+    int spacing() const;
+
+    // Axes
+
+    void enableAxis( int axisId, bool on = true );
+    bool axisEnabled( int axisId ) const;
+
+    void setAxisScaleDiv( int axisId, const QwtScaleDiv & );
+    const QwtScaleDiv &axisScaleDiv( int axisId ) const;
+
+    void setAxisTransformation( int axisId, QwtTransform * );
+    const QwtTransform *axisTransformation( int axisId ) const;
+
+    void setAxisScaleDraw( int axisId, QwtScaleDraw * );
+    const QwtScaleDraw *axisScaleDraw( int axisId ) const;
+    QwtScaleDraw *axisScaleDraw( int axisId );
+
+    void setAxisTitle( int axisId, const QwtText & );
+    QwtText axisTitle( int axisId ) const;
+
+    void setAxisFont( int axisId, const QFont & );
+    QFont axisFont( int axisId ) const;
+
+    // Rendering
+
+    void render( QPainter *, const QRectF &rect ) const;
+    void renderTo( QPaintDevice & ) const;
+
+    QImage toImage( const QSize &, int resolution = 96,
+        QImage::Format = QImage::Format_ARGB32 ) const;
+
+    bool renderDocument( const QString &fileName,
+        const QSizeF &sizeMM, int resolution = 85 ) const;
+
+    bool renderDocument( const QString &fileName, const QString &format,
+        const QSizeF &sizeMM, int resolution = 85 ) const;
+
+    QRectF canvasRect( const QRectF &rect, const QPaintDevice * ) const;
+
+protected:
+    virtual void drawItems( QPainter *, const QRectF &canvasRect,
+        const QwtScaleMap maps[QwtPlot::axisCnt] ) const;
+
+    virtual void drawScale( QPainter *, int axisId,
+        const QRectF &scaleRect, const QRectF &canvasRect ) const;
+
+private:
+    Q_DISABLE_COPY(QwtPlotScene)
+
+    class PrivateData;
+    PrivateData *d_data;
+};
+
+#endif
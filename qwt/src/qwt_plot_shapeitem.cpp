@@ -12,6 +12,8 @@
 #include "qwt_painter.h"
 #include "qwt_weeding_curve_fitter.h"
 #include "qwt_clipper.h"
+#include <qapplication.h>
+#include <qthread.h>
 
 static QPainterPath qwtTransformPath( const QwtScaleMap &xMap,
         const QwtScaleMap &yMap, const QPainterPath &path, bool doAlign )
@@ -74,6 +76,53 @@ static QPainterPath qwtTransformPath( const QwtScaleMap &xMap,
 }
 
 
+static inline bool qwtIsEqual( const QwtScaleMap &map1, const QwtScaleMap &map2 )
+{
+    if ( map1.s1() != map2.s1() || map1.s2() != map2.s2()
+        || map1.p1() != map2.p1() || map1.p2() != map2.p2() )
+    {
+        return false;
+    }
+
+    // maps with different transformations differ in the middle
+    const double s = 0.5 * ( map1.s1() + map1.s2() );
+    return map1.transform( s ) == map2.transform( s );
+}
+
+static bool qwtIsTooSmall( const QPolygonF &polygon, double minSize )
+{
+    if ( polygon.isEmpty() )
+        return true;
+
+    const QPointF *points = polygon.constData();
+
+    double minX = points[0].x();
+    double maxX = minX;
+    double minY = points[0].y();
+    double maxY = minY;
+
+    for ( int i = 1; i < polygon.size(); i++ )
+    {
+        const double x = points[i].x();
+        const double y = points[i].y();
+
+        if ( x < minX )
+            minX = x;
+        else if ( x > maxX )
+            maxX = x;
+
+        if ( y < minY )
+            minY = y;
+        else if ( y > maxY )
+            maxY = y;
+
+        if ( ( maxX - minX ) >= minSize || ( maxY - minY ) >= minSize )
+            return false;
+    }
+
+    return true;
+}
+
 class QwtPlotShapeItem::PrivateData
 {
 public:
@@ -81,6 +130,8 @@ public:
         legendMode( QwtPlotShapeItem::LegendColor ),
         renderTolerance( 0.0 )
     {
+        cache.isValid = false;
+        cache.doAlign = false;
     }
 
     QwtPlotShapeItem::PaintAttributes paintAttributes;
@@ -92,6 +143,18 @@ public:
     QPen pen;
     QBrush brush;
     QPainterPath shape;
+
+    struct GeometryCache
+    {
+        bool isValid;
+
+        QwtScaleMap xMap;
+        QwtScaleMap yMap;
+        QRectF canvasRect;
+        bool doAlign;
+
+        QPainterPath path;
+    } cache;
 };
 
 /*!
@@ -160,6 +223,8 @@ void QwtPlotShapeItem::setPaintAttribute( PaintAttribute attribute, bool on )
         d_data->paintAttributes |= attribute;
     else
         d_data->paintAttributes &= ~attribute;
+
+    invalidateCache();
 }
 
 /*!
@@ -240,6 +305,8 @@ void QwtPlotShapeItem::setShape( const QPainterPath &shape )
     if ( shape != d_data->shape )
     {
         d_data->shape = shape;
+        invalidateCache();
+
         if ( shape.isEmpty() )
         {
             d_data->boundingRect = QwtPlotItem::boundingRect();
@@ -292,6 +359,12 @@ void QwtPlotShapeItem::setPen( const QPen &pen )
 {
     if ( pen != d_data->pen )
     {
+        if ( pen.widthF() != d_data->pen.widthF() )
+        {
+            // the pen width is part of the clip rectangle
+            invalidateCache();
+        }
+
         d_data->pen = pen;
         itemChanged();
     }
@@ -355,6 +428,8 @@ void QwtPlotShapeItem::setRenderTolerance( double tolerance )
     if ( tolerance != d_data->renderTolerance )
     {
         d_data->renderTolerance = tolerance;
+        invalidateCache();
+
         itemChanged();
     }
 }
@@ -403,48 +478,113 @@ void QwtPlotShapeItem::draw( QPainter *painter,
 
     const bool doAlign = QwtPainter::roundingAlignment( painter );
 
-    QPainterPath path = qwtTransformPath( xMap, yMap, 
-        d_data->shape, doAlign );
-
-    if ( testPaintAttribute( QwtPlotShapeItem::ClipPolygons ) )
+    bool useCache = testPaintAttribute( CacheGeometry );
+    if ( useCache && qApp && QThread::currentThread() != qApp->thread() )
     {
-        qreal pw = qMax( qreal( 1.0 ), painter->pen().widthF());
-        QRectF clipRect = canvasRect.adjusted( -pw, -pw, pw, pw );
+        // draw() is const: no cache updates from worker threads
+        useCache = false;
+    }
 
-        QPainterPath clippedPath;
-        clippedPath.setFillRule( path.fillRule() );
+    QPainterPath path;
 
-        const QList<QPolygonF> polygons = path.toSubpathPolygons();
-        for ( int i = 0; i < polygons.size(); i++ )
-        {
-            const QPolygonF p = QwtClipper::clipPolygonF(
-                clipRect, polygons[i], true );
+    if ( useCache )
+    {
+        PrivateData::GeometryCache &cache = d_data->cache;
 
-            clippedPath.addPolygon( p );
+        if ( !( cache.isValid && cache.doAlign == doAlign
+            && cache.canvasRect == canvasRect
+            && qwtIsEqual( cache.xMap, xMap )
+            && qwtIsEqual( cache.yMap, yMap ) ) )
+        {
+            cache.path = mappedShape( xMap, yMap, canvasRect, doAlign );
 
+            cache.xMap = xMap;
+            cache.yMap = yMap;
+            cache.canvasRect = canvasRect;
+            cache.doAlign = doAlign;
+            cache.isValid = true;
         }
 
-        path = clippedPath;
+        path = cache.path;
     }
-
-    if ( d_data->renderTolerance > 0.0 )
+    else
     {
-        QwtWeedingCurveFitter fitter( d_data->renderTolerance );
+        path = mappedShape( xMap, yMap, canvasRect, doAlign );
+    }
+
+    painter->setPen( d_data->pen );
+    painter->setBrush( d_data->brush );
+
+    painter->drawPath( path );
+}
+
+/*!
+  Map the shape into paint device coordinates and
+  apply the optimizations of the paint attributes
+
+  \param xMap X-Scale Map
+  \param yMap Y-Scale Map
+  \param canvasRect Contents rect of the plot canvas
+  \param doAlign Round the points to integers
+
+  \return Path to be painted
+*/
+QPainterPath QwtPlotShapeItem::mappedShape( const QwtScaleMap &xMap,
+    const QwtScaleMap &yMap, const QRectF &canvasRect, bool doAlign ) const
+{
+    QPainterPath path = qwtTransformPath( xMap, yMap,
+        d_data->shape, doAlign );
+
+    const bool doClip = d_data->paintAttributes & ClipPolygons;
+    const bool doLod = d_data->paintAttributes & LevelOfDetail;
+    const bool doWeed = d_data->renderTolerance > 0.0;
 
-        QPainterPath fittedPath;
-        fittedPath.setFillRule( path.fillRule() );
+    if ( !( doClip || doLod || doWeed ) )
+        return path;
+
+    // converting the path into polygons only once for all steps
+
+    QList<QPolygonF> polygons = path.toSubpathPolygons();
+
+    if ( doClip )
+    {
+        const qreal pw = qMax( qreal( 1.0 ), d_data->pen.widthF() );
+        const QRectF clipRect = canvasRect.adjusted( -pw, -pw, pw, pw );
 
-        const QList<QPolygonF> polygons = path.toSubpathPolygons();
         for ( int i = 0; i < polygons.size(); i++ )
-            fittedPath.addPolygon( fitter.fitCurve( polygons[ i ] ) );
+        {
+            polygons[i] = QwtClipper::clipPolygonF(
+                clipRect, polygons[i], true );
+        }
+    }
+
+    QwtWeedingCurveFitter fitter( d_data->renderTolerance );
+    const double minSize = qMax( d_data->renderTolerance, 1.0 );
+
+    QPainterPath mappedPath;
+    mappedPath.setFillRule( path.fillRule() );
 
-        path = fittedPath;
+    for ( int i = 0; i < polygons.size(); i++ )
+    {
+        const QPolygonF &polygon = polygons[i];
+
+        if ( doLod && qwtIsTooSmall( polygon, minSize ) )
+            continue;
+
+        if ( doWeed )
+            mappedPath.addPolygon( fitter.fitCurve( polygon ) );
+        else
+            mappedPath.addPolygon( polygon );
     }
 
-    painter->setPen( d_data->pen );
-    painter->setBrush( d_data->brush );
+    return mappedPath;
+}
 
-    painter->drawPath( path );
+//! Discard the cached geometry
+void QwtPlotShapeItem::invalidateCache()
+{
+    d_data->cache.isValid = false;
+    d_data->cache.path = QPainterPath();
 }
 
 /*!
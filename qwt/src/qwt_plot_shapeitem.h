@@ -49,6 +49,29 @@ public:
           performance of paths composed from curves or ellipses.
          */
         ClipPolygons = 0x01,
+
+        /*!
+          Keep the shape, that has been mapped to paint device coordinates,
+          clipped and weeded. As long as the scale maps and the canvas
+          geometry don't change, the cached path is painted without
+          processing the shape again.
+
+          The cache is a copy of the mapped path, what needs memory
+          similar to the shape itself. It is not used, when painting
+          outside of the GUI thread.
+         */
+        CacheGeometry = 0x02,
+
+        /*!
+          Subpaths, whose bounding rectangle in paint device coordinates is
+          smaller than the renderTolerance() - or at least a pixel - are
+          not painted. When zooming out, many small parts of a shape,
+          f.e. the islands of a map, disappear.
+
+          As this attribute needs to convert the painter path into
+          polygons, it is mostly useful for shapes built from polygons.
+         */
+        LevelOfDetail = 0x04
     };
 
     //! Paint attributes
@@ -103,6 +126,11 @@ public:
 
 private:
     void init();
+    void invalidateCache();
+
+    QPainterPath mappedShape( const QwtScaleMap &xMap,
+        const QwtScaleMap &yMap, const QRectF &canvasRect,
+        bool doAlign ) const;
 
     class PrivateData;
     PrivateData *d_data;
@@ -11,7 +11,192 @@
 #include "qwt_color_map.h"
 #include "qwt_scale_map.h"
 #include "qwt_painter.h"
+#include "qwt_symbol.h"
+#include "qwt_sprite_renderer.h"
 #include <qpainter.h>
+#include <qpaintengine.h>
+#include <qmap.h>
+#include <qhash.h>
+#include <qthread.h>
+#include <qfuture.h>
+#include <qtconcurrentrun.h>
+
+static void qwtColorizeSymbol( QwtSymbol *symbol,
+    const QBrush &brush, const QPen &pen, QRgb rgb )
+{
+    const QColor color = QColor::fromRgba( rgb );
+
+    if ( brush.style() == Qt::NoBrush )
+    {
+        QPen p = pen;
+        p.setColor( color );
+
+        symbol->setPen( p );
+    }
+    else
+    {
+        QBrush b = brush;
+        b.setColor( color );
+
+        symbol->setBrush( b );
+    }
+}
+
+static QImage qwtSymbolSprite( const QwtSymbol *symbol,
+    QPainter::RenderHints hints, QPoint &offset )
+{
+    const QRect br = symbol->boundingRect();
+    if ( br.isEmpty() )
+        return QImage();
+
+    QImage image( br.size(), QImage::Format_ARGB32_Premultiplied );
+    image.fill( 0 );
+
+    QPainter painter( &image );
+    painter.setRenderHints( hints );
+    painter.translate( -br.topLeft() );
+
+    symbol->drawSymbol( &painter, QPointF( 0.0, 0.0 ) );
+
+    painter.end();
+
+    offset = br.topLeft();
+    return image;
+}
+
+static inline QRgb qwtPremultiplied( QRgb rgb )
+{
+    const uint alpha = qAlpha( rgb );
+    if ( alpha == 255 )
+        return rgb;
+
+    if ( alpha == 0 )
+        return 0;
+
+    return qRgba( qRed( rgb ) * alpha / 255, qGreen( rgb ) * alpha / 255,
+        qBlue( rgb ) * alpha / 255, alpha );
+}
+
+namespace
+{
+    class Dot
+    {
+    public:
+        // pixel position in the layer
+        int x;
+        int y;
+
+        // premultiplied color, 0 for nothing to paint
+        QRgb rgb;
+    };
+}
+
+// Helper class to work around the 5 parameters
+// limitation of QtConcurrent::run()
+class QwtSpectroDotsCommand
+{
+public:
+    const QwtSeriesData<QwtPoint3D> *series;
+    int from;
+
+    const QwtScaleMap *xMap;
+    const QwtScaleMap *yMap;
+
+    const QwtColorMap *colorMap;
+    QwtInterval colorRange;
+    const QRgb *colorTable;
+
+    QRect layerRect;
+
+    Dot *dots;
+    int numDots;
+
+    QImage *layer;
+};
+
+static void qwtMapDots( const QwtSpectroDotsCommand &command, int i0, int i1 )
+{
+    // mapping the samples [i0, i1[ to pixels of the layer
+
+    const QRect &r = command.layerRect;
+
+    for ( int i = i0; i < i1; i++ )
+    {
+        const QwtPoint3D sample = command.series->sample( command.from + i );
+
+        Dot &dot = command.dots[i];
+        dot.x = dot.y = 0;
+        dot.rgb = 0;
+
+        // checking the range before rounding, as qRound() overflows
+        // for positions far beyond the layer. NaNs fail the check too.
+
+        const double x = command.xMap->transform( sample.x() ) - r.left();
+        const double y = command.yMap->transform( sample.y() ) - r.top();
+
+        if ( !( x >= -0.5 && x < r.width() - 0.5
+            && y >= -0.5 && y < r.height() - 0.5 ) )
+        {
+            continue;
+        }
+
+        dot.x = qRound( x );
+        dot.y = qRound( y );
+
+        QRgb rgb;
+        if ( command.colorTable )
+        {
+            rgb = command.colorTable[ command.colorMap->colorIndex(
+                256, command.colorRange, sample.z() ) ];
+        }
+        else
+        {
+            rgb = command.colorMap->rgb( command.colorRange, sample.z() );
+        }
+
+        dot.rgb = qwtPremultiplied( rgb );
+    }
+}
+
+static void qwtPaintDots( const QwtSpectroDotsCommand &command, int y0, int y1 )
+{
+    // painting the dots in the rows [y0, y1[ of the layer,
+    // keeping the order of the samples
+
+    QImage *layer = command.layer;
+
+    uchar *bits = layer->bits();
+    const int bytesPerLine = layer->bytesPerLine();
+
+    for ( int i = 0; i < command.numDots; i++ )
+    {
+        const Dot &dot = command.dots[i];
+
+        if ( dot.rgb == 0 || dot.y < y0 || dot.y >= y1 )
+            continue;
+
+        QRgb *pixel = reinterpret_cast<QRgb *>( bits + dot.y * bytesPerLine ) + dot.x;
+        *pixel = QwtSpriteRenderer::blendPixel( dot.rgb, *pixel );
+    }
+}
+
+static int qwtNumThreads( int numPoints )
+{
+    int numThreads = 1;
+
+#if !defined(QT_NO_QFUTURE)
+    if ( numPoints > 100000 )
+    {
+        numThreads = QThread::idealThreadCount();
+        if ( numThreads <= 0 )
+            numThreads = 1;
+    }
+#else
+    Q_UNUSED( numPoints )
+#endif
+
+    return numThreads;
+}
 
 class QwtPlotSpectroCurve::PrivateData
 {
@@ -19,7 +204,9 @@ public:
     PrivateData():
         colorRange( 0.0, 1000.0 ),
         penWidth(0.0),
-        paintAttributes( QwtPlotSpectroCurve::ClipPoints )
+        paintAttributes( QwtPlotSpectroCurve::ClipPoints ),
+        symbol( NULL ),
+        lastTable( NULL )
     {
         colorMap = new QwtLinearColorMap();
     }
@@ -27,6 +214,57 @@ public:
     ~PrivateData()
     {
         delete colorMap;
+        delete symbol;
+    }
+
+    void clearSprites()
+    {
+        spriteRenderer.clear();
+        spriteTables.clear();
+        lastTable = NULL;
+    }
+
+    int spriteId( const QSize &size, uint colorIndex,
+        QPainter::RenderHints hints )
+    {
+        // a table of sprite ids for the 256 colors of each size
+
+        const QPair<int, int> key( size.width(), size.height() );
+
+        if ( lastTable == NULL || key != lastKey )
+        {
+            QMap< QPair<int, int>, QVector<int> >::iterator it =
+                spriteTables.find( key );
+
+            if ( it == spriteTables.end() )
+                it = spriteTables.insert( key, QVector<int>( 256, -2 ) );
+
+            lastKey = key;
+            lastTable = it.value().data();
+        }
+
+        int &id = lastTable[ colorIndex ];
+        if ( id == -2 )
+        {
+            const QBrush brush = symbol->brush();
+            const QPen pen = symbol->pen();
+            const QSize symbolSize = symbol->size();
+
+            symbol->setSize( size );
+            qwtColorizeSymbol( symbol, brush, pen, colorTable[ colorIndex ] );
+
+            QPoint offset;
+            const QImage image = qwtSymbolSprite( symbol, hints, offset );
+
+            symbol->setSize( symbolSize );
+            symbol->setBrush( brush );
+            symbol->setPen( pen );
+
+            // -1: nothing to paint for this size
+            id = image.isNull() ? -1 : spriteRenderer.addSprite( image, offset );
+        }
+
+        return id;
     }
 
     QwtColorMap *colorMap;
@@ -34,6 +272,16 @@ public:
     QVector<QRgb> colorTable;
     double penWidth;
     QwtPlotSpectroCurve::PaintAttributes paintAttributes;
+
+    QwtSymbol *symbol;
+
+    QwtSpriteRenderer spriteRenderer;
+    QMap< QPair<int, int>, QVector<int> > spriteTables;
+    QPainter::RenderHints spriteHints;
+
+    // the table of the size, that has been looked up last
+    QPair<int, int> lastKey;
+    int *lastTable;
 };
 
 /*!
@@ -150,6 +398,8 @@ void QwtPlotSpectroCurve::setColorMap( QwtColorMap *colorMap )
         d_data->colorMap = colorMap;
     }
 
+    d_data->clearSprites();
+
     legendChanged();
     itemChanged();
 }
@@ -220,6 +470,42 @@ double QwtPlotSpectroCurve::penWidth() const
     return d_data->penWidth;
 }
 
+/*!
+  \brief Assign a symbol
+
+  The curve will take the ownership of the symbol, hence the previously
+  set symbol will be delete by setting a new one. If \p symbol is
+  \c NULL the points are displayed as dots.
+
+  The color of the brush, or of the pen for symbols without a brush,
+  is replaced by the color of the z coordinate for each point.
+
+  \param symbol Symbol
+  \sa symbol(), drawSymbols(), symbolSize()
+*/
+void QwtPlotSpectroCurve::setSymbol( QwtSymbol *symbol )
+{
+    if ( symbol != d_data->symbol )
+    {
+        delete d_data->symbol;
+        d_data->symbol = symbol;
+
+        d_data->clearSprites();
+
+        legendChanged();
+        itemChanged();
+    }
+}
+
+/*!
+  \return Current symbol or NULL, when no symbol has been assigned
+  \sa setSymbol()
+*/
+const QwtSymbol *QwtPlotSpectroCurve::symbol() const
+{
+    return d_data->symbol;
+}
+
 /*!
   Draw a subset of the points
 
@@ -231,7 +517,7 @@ double QwtPlotSpectroCurve::penWidth() const
   \param to Index of the last sample to be painted. If to < 0 the
          series will be painted to its last sample.
 
-  \sa drawDots()
+  \sa drawDots(), drawSymbols()
 */
 void QwtPlotSpectroCurve::drawSeries( QPainter *painter,
     const QwtScaleMap &xMap, const QwtScaleMap &yMap,
@@ -249,12 +535,22 @@ void QwtPlotSpectroCurve::drawSeries( QPainter *painter,
     if ( from > to )
         return;
 
-    drawDots( painter, xMap, yMap, canvasRect, from, to );
+    if ( d_data->symbol && d_data->symbol->style() != QwtSymbol::NoSymbol )
+        drawSymbols( painter, xMap, yMap, canvasRect, from, to );
+    else
+        drawDots( painter, xMap, yMap, canvasRect, from, to );
 }
 
 /*!
   Draw a subset of the points
 
+  On raster devices dots with a width of 1 pixel are colorized into an
+  image first, that is painted with one QPainter::drawImage() call. Mapping
+  and colorizing is done by concurrent threads for large series.
+
+  Otherwise the samples are sorted by color and the dots of each color
+  are painted with one QPainter::drawPoints() call.
+
   \param painter Painter
   \param xMap Maps x-values into pixel coordinates.
   \param yMap Maps y-values into pixel coordinates.
@@ -272,12 +568,143 @@ void QwtPlotSpectroCurve::drawDots( QPainter *painter,
     if ( !d_data->colorRange.isValid() )
         return;
 
-    const bool doAlign = QwtPainter::roundingAlignment( painter );
-
     const QwtColorMap::Format format = d_data->colorMap->format();
     if ( format == QwtColorMap::Indexed )
         d_data->colorTable = d_data->colorMap->colorTable256();
 
+    if ( !drawDotsImage( painter, xMap, yMap, canvasRect, from, to ) )
+        drawDotsBuckets( painter, xMap, yMap, canvasRect, from, to );
+
+    d_data->colorTable.clear();
+}
+
+bool QwtPlotSpectroCurve::drawDotsImage( QPainter *painter,
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QRectF &canvasRect, int from, int to ) const
+{
+    // isSupported() is false for devices with a pixel ratio != 1,
+    // where a dot would have to cover more than one pixel of the layer
+
+    if ( d_data->penWidth > 1.0
+        || painter->testRenderHint( QPainter::Antialiasing )
+        || !QwtSpriteRenderer::isSupported( painter ) )
+    {
+        return false;
+    }
+
+    // no need to have pixels outside of the device or clip region
+
+    const QPaintDevice *device = painter->device();
+
+    QRect layerRect = painter->transform().inverted().mapRect(
+        QRect( 0, 0, device->width(), device->height() ) );
+
+    if ( painter->hasClipping() )
+        layerRect &= painter->clipBoundingRect().toAlignedRect();
+
+    if ( d_data->paintAttributes & QwtPlotSpectroCurve::ClipPoints )
+        layerRect &= canvasRect.toAlignedRect();
+
+    if ( layerRect.isEmpty() )
+        return true;
+
+    const int numPoints = to - from + 1;
+
+    const qint64 layerArea = qint64( layerRect.width() ) * layerRect.height();
+    if ( layerArea > 16 * qint64( numPoints ) )
+    {
+        // a few sparse dots on a large area
+        return false;
+    }
+
+    QImage layer( layerRect.size(), QImage::Format_ARGB32_Premultiplied );
+    if ( layer.isNull() )
+        return false;
+
+    layer.fill( 0 );
+
+    QVector<Dot> dots( numPoints );
+
+    QwtSpectroDotsCommand command;
+    command.series = data();
+    command.from = from;
+    command.xMap = &xMap;
+    command.yMap = &yMap;
+    command.colorMap = d_data->colorMap;
+    command.colorRange = d_data->colorRange;
+    command.colorTable = d_data->colorTable.isEmpty()
+        ? NULL : d_data->colorTable.constData();
+    command.layerRect = layerRect;
+    command.dots = dots.data();
+    command.numDots = numPoints;
+    command.layer = &layer;
+
+    const int numThreads = qMin( qwtNumThreads( numPoints ), layerRect.height() );
+
+    // mapping and colorizing in chunks of samples
+
+    const int chunkSize = numPoints / numThreads;
+
+#if !defined(QT_NO_QFUTURE)
+    QList< QFuture<void> > futures;
+    for ( int i = 0; i < numThreads - 1; i++ )
+    {
+        futures += QtConcurrent::run( &qwtMapDots,
+            command, i * chunkSize, ( i + 1 ) * chunkSize );
+    }
+#endif
+
+    qwtMapDots( command, ( numThreads - 1 ) * chunkSize, numPoints );
+
+#if !defined(QT_NO_QFUTURE)
+    for ( int i = 0; i < futures.size(); i++ )
+        futures[i].waitForFinished();
+
+    futures.clear();
+#endif
+
+    // painting in bands of rows
+
+    const int numRows = layerRect.height() / numThreads;
+
+#if !defined(QT_NO_QFUTURE)
+    for ( int i = 0; i < numThreads - 1; i++ )
+    {
+        futures += QtConcurrent::run( &qwtPaintDots,
+            command, i * numRows, ( i + 1 ) * numRows );
+    }
+#endif
+
+    qwtPaintDots( command, ( numThreads - 1 ) * numRows, layerRect.height() );
+
+#if !defined(QT_NO_QFUTURE)
+    for ( int i = 0; i < futures.size(); i++ )
+        futures[i].waitForFinished();
+#endif
+
+    painter->drawImage( layerRect.topLeft(), layer );
+
+    return true;
+}
+
+void QwtPlotSpectroCurve::drawDotsBuckets( QPainter *painter,
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QRectF &canvasRect, int from, int to ) const
+{
+    const bool doAlign = QwtPainter::roundingAlignment( painter );
+    const bool doClip =
+        d_data->paintAttributes & QwtPlotSpectroCurve::ClipPoints;
+
+    const QwtColorMap::Format format = d_data->colorMap->format();
+
+    // the dots of each color, in the order of their first appearance
+
+    QVector<QRgb> colors;
+    QVector<QPolygonF> buckets;
+    QHash<QRgb, int> bucketIndexes;
+
+    int lastIndex = -1;
+
     const QwtSeriesData<QwtPoint3D> *series = data();
 
     for ( int i = from; i <= to; i++ )
@@ -292,30 +719,205 @@ void QwtPlotSpectroCurve::drawDots( QPainter *painter,
             yi = qRound( yi );
         }
 
-        if ( d_data->paintAttributes & QwtPlotSpectroCurve::ClipPoints )
-        {
-            if ( !canvasRect.contains( xi, yi ) )
-                continue;
-        }
+        if ( doClip && !canvasRect.contains( xi, yi ) )
+            continue;
 
+        QRgb rgb;
         if ( format == QwtColorMap::RGB )
         {
-            const QRgb rgb = d_data->colorMap->rgb(
-                d_data->colorRange, sample.z() );
-
-            painter->setPen( QPen( QColor::fromRgba( rgb ), d_data->penWidth ) );
+            rgb = d_data->colorMap->rgb( d_data->colorRange, sample.z() );
         }
         else
         {
             const unsigned char index = d_data->colorMap->colorIndex(
                 256, d_data->colorRange, sample.z() );
 
-            painter->setPen( QPen( QColor::fromRgba( d_data->colorTable[index] ), 
-                d_data->penWidth ) );
+            rgb = d_data->colorTable[index];
+        }
+
+        if ( lastIndex < 0 || colors[lastIndex] != rgb )
+        {
+            QHash<QRgb, int>::const_iterator it = bucketIndexes.constFind( rgb );
+            if ( it == bucketIndexes.constEnd() )
+            {
+                lastIndex = colors.size();
+                bucketIndexes.insert( rgb, lastIndex );
+
+                colors += rgb;
+                buckets += QPolygonF();
+            }
+            else
+            {
+                lastIndex = it.value();
+            }
+        }
+
+        buckets[lastIndex] += QPointF( xi, yi );
+    }
+
+    for ( int i = 0; i < buckets.size(); i++ )
+    {
+        painter->setPen( QPen( QColor::fromRgba( colors[i] ), d_data->penWidth ) );
+        QwtPainter::drawPoints( painter, buckets[i] );
+    }
+}
+
+/*!
+  Draw symbols for a subset of the points
+
+  On raster devices the symbols are stamped from images, that are
+  cached for each combination of size and color. On vector devices
+  each symbol is painted as vector graphic.
+
+  \param painter Painter
+  \param xMap Maps x-values into pixel coordinates.
+  \param yMap Maps y-values into pixel coordinates.
+  \param canvasRect Contents rectangle of the canvas
+  \param from Index of the first sample to be painted
+  \param to Index of the last sample to be painted. If to < 0 the
+         series will be painted to its last sample.
+
+  \sa setSymbol(), symbolSize(), drawSeries(), QwtSpriteRenderer
+*/
+void QwtPlotSpectroCurve::drawSymbols( QPainter *painter,
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QRectF &canvasRect, int from, int to ) const
+{
+    QwtSymbol *symbol = d_data->symbol;
+
+    if ( symbol == NULL || !d_data->colorRange.isValid() )
+        return;
+
+    const bool doAlign = QwtPainter::roundingAlignment( painter );
+    const bool doClip =
+        d_data->paintAttributes & QwtPlotSpectroCurve::ClipPoints;
+
+    const bool useSprites = QwtSpriteRenderer::isSupported( painter );
+    if ( useSprites && painter->renderHints() != d_data->spriteHints )
+    {
+        d_data->clearSprites();
+        d_data->spriteHints = painter->renderHints();
+    }
+
+    d_data->colorTable = d_data->colorMap->colorTable256();
+
+    const QBrush brush = symbol->brush();
+    const QPen pen = symbol->pen();
+    const QSize size = symbol->size();
+    const QSize boundingSize = symbol->boundingRect().size();
+
+    QVector<QPointF> points;
+    QVector<int> spriteIds;
+
+    if ( useSprites )
+    {
+        points.reserve( to - from + 1 );
+        spriteIds.reserve( to - from + 1 );
+    }
+
+    const QwtSeriesData<QwtPoint3D> *series = data();
+
+    for ( int i = from; i <= to; i++ )
+    {
+        const QwtPoint3D sample = series->sample( i );
+
+        double xi = xMap.transform( sample.x() );
+        double yi = yMap.transform( sample.y() );
+        if ( doAlign )
+        {
+            xi = qRound( xi );
+            yi = qRound( yi );
         }
 
-        QwtPainter::drawPoint( painter, QPointF( xi, yi ) );
+        const QSize sz = symbolSize( i, sample );
+
+        if ( doClip )
+        {
+            // the symbol might be partly visible
+
+            const QSize margin = sz.isValid() ? sz : boundingSize;
+
+            const QRectF clipRect = canvasRect.adjusted(
+                -margin.width(), -margin.height(),
+                margin.width(), margin.height() );
+
+            if ( !clipRect.contains( xi, yi ) )
+                continue;
+        }
+
+        const uint colorIndex = d_data->colorMap->colorIndex(
+            256, d_data->colorRange, sample.z() );
+
+        if ( useSprites )
+        {
+            const int id = d_data->spriteId( sz, colorIndex,
+                d_data->spriteHints );
+
+            if ( id >= 0 )
+            {
+                points += QPointF( xi, yi );
+                spriteIds += id;
+            }
+        }
+        else
+        {
+            symbol->setSize( sz );
+            qwtColorizeSymbol( symbol, brush, pen,
+                d_data->colorTable[ colorIndex ] );
+
+            symbol->drawSymbol( painter, QPointF( xi, yi ) );
+        }
+    }
+
+    if ( useSprites )
+    {
+        const QwtSpriteRenderer &renderer = d_data->spriteRenderer;
+
+        if ( !renderer.render( painter, points.constData(),
+            spriteIds.constData(), points.size() ) )
+        {
+            // only a few symbols: painting them one by one
+
+            for ( int i = 0; i < points.size(); i++ )
+            {
+                const int id = spriteIds[i];
+
+                const QPoint pos = points[i].toPoint() + renderer.offset( id );
+                painter->drawImage( pos, renderer.sprite( id ) );
+            }
+        }
+    }
+    else
+    {
+        symbol->setSize( size );
+        symbol->setBrush( brush );
+        symbol->setPen( pen );
     }
 
     d_data->colorTable.clear();
 }
+
+/*!
+  \brief Size of the symbol for a sample
+
+  The default implementation returns the size of the symbol().
+  Overload this method to display symbols with different sizes, f.e.
+  for encoding an additional value of the sample.
+
+  On raster devices an image is cached for each combination of size
+  and color, so the number of different sizes should be limited.
+
+  \param sampleIndex Index of the sample
+  \param sample Sample
+  \return Size of the symbol
+
+  \sa setSymbol(), drawSymbols()
+*/
+QSize QwtPlotSpectroCurve::symbolSize(
+    int sampleIndex, const QwtPoint3D &sample ) const
+{
+    Q_UNUSED( sampleIndex );
+    Q_UNUSED( sample );
+
+    return d_data->symbol ? d_data->symbol->size() : QSize();
+}
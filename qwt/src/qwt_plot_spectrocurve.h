@@ -20,6 +20,19 @@ class QwtColorMap;
 /*!
     \brief Curve that displays 3D points as dots, where the z coordinate is
            mapped to a color.
+
+    When a symbol has been assigned the points are displayed as symbols
+    instead of dots, where the color of the z coordinate is used for the
+    brush of the symbol. Symbols without a brush, like crosses, get
+    the color for their pen. The size of each symbol can be varied by
+    overloading symbolSize().
+
+    On raster devices the symbols are rendered from images for each
+    combination of color and size, that are blended together, so that
+    even a million of symbols can be displayed in one pass. For this
+    the color map is reduced to 256 colors - see QwtColorMap::colorIndex().
+
+    \sa QwtSpriteRenderer
 */
 class QWT_EXPORT QwtPlotSpectroCurve: 
     public QwtPlotSeriesItem, QwtSeriesStore<QwtPoint3D>
@@ -62,14 +75,31 @@ public:
     void setPenWidth(double width);
     double penWidth() const;
 
+    void setSymbol( QwtSymbol * );
+    const QwtSymbol *symbol() const;
+
 protected:
     virtual void drawDots( QPainter *,
         const QwtScaleMap &xMap, const QwtScaleMap &yMap,
         const QRectF &canvasRect, int from, int to ) const;
 
+    virtual void drawSymbols( QPainter *,
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QRectF &canvasRect, int from, int to ) const;
+
+    virtual QSize symbolSize( int sampleIndex, const QwtPoint3D & ) const;
+
 private:
     void init();
 
+    bool drawDotsImage( QPainter *,
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QRectF &canvasRect, int from, int to ) const;
+
+    void drawDotsBuckets( QPainter *,
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QRectF &canvasRect, int from, int to ) const;
+
     class PrivateData;
     PrivateData *d_data;
 };
@@ -10,18 +10,72 @@
 #include "qwt_plot_svgitem.h"
 #include "qwt_scale_map.h"
 #include "qwt_painter.h"
+#include "qwt_math.h"
 #include <qpainter.h>
+#include <qpaintengine.h>
+#include <qimage.h>
 #include <qsvgrenderer.h>
+#include <qapplication.h>
+#include <qthread.h>
+
+// tiles with more pixels are not cached
+static const qint64 qwtMaxTileSize = 16 * 1024 * 1024;
+
+static bool qwtUseCache( QwtPlotSvgItem::CachePolicy policy,
+    const QPainter *painter )
+{
+    bool doCache = false;
+
+    if ( policy == QwtPlotSvgItem::PaintCache )
+    {
+        // Caching doesn't make sense, when the item is
+        // not painted to screen
+
+        switch ( painter->paintEngine()->type() )
+        {
+            case QPaintEngine::SVG:
+            case QPaintEngine::Pdf:
+            case QPaintEngine::PostScript:
+            case QPaintEngine::MacPrinter:
+            case QPaintEngine::Picture:
+                break;
+            default:;
+                doCache = true;
+        }
+    }
+
+    if ( doCache && qApp && QThread::currentThread() != qApp->thread() )
+    {
+        // the tile is modified in the GUI thread only
+        doCache = false;
+    }
+
+    return doCache;
+}
 
 class QwtPlotSvgItem::PrivateData
 {
 public:
     PrivateData()
     {
+        cache.policy = QwtPlotSvgItem::NoCache;
+        cache.scaleX = cache.scaleY = 0.0;
     }
 
     QRectF boundingRect;
     QSvgRenderer renderer;
+
+    struct TileCache
+    {
+        QwtPlotSvgItem::CachePolicy policy;
+
+        // view box of the tile and pixels per view box unit
+        QRectF viewBox;
+        double scaleX;
+        double scaleY;
+
+        QImage image;
+    } cache;
 };
 
 /*!
@@ -91,6 +145,8 @@ bool QwtPlotSvgItem::loadFile( const QRectF &rect,
     d_data->boundingRect = rect;
     const bool ok = d_data->renderer.load( fileName );
 
+    invalidateCache();
+
     legendChanged();
     itemChanged();
 
@@ -111,12 +167,57 @@ bool QwtPlotSvgItem::loadData( const QRectF &rect,
     d_data->boundingRect = rect;
     const bool ok = d_data->renderer.load( data );
 
+    invalidateCache();
+
     legendChanged();
     itemChanged();
 
     return ok;
 }
 
+/*!
+  Change the cache policy
+
+  The default policy is NoCache
+
+  \param policy Cache policy
+  \sa CachePolicy, cachePolicy()
+*/
+void QwtPlotSvgItem::setCachePolicy( CachePolicy policy )
+{
+    if ( d_data->cache.policy != policy )
+    {
+        d_data->cache.policy = policy;
+
+        invalidateCache();
+        itemChanged();
+    }
+}
+
+/*!
+  \return Cache policy
+  \sa CachePolicy, setCachePolicy()
+*/
+QwtPlotSvgItem::CachePolicy QwtPlotSvgItem::cachePolicy() const
+{
+    return d_data->cache.policy;
+}
+
+/*!
+   Invalidate the tile cache
+
+   The cache is invalidated, when a document is loaded. Modifications
+   of the document by renderer() need to invalidate the cache manually.
+
+   \sa setCachePolicy()
+*/
+void QwtPlotSvgItem::invalidateCache()
+{
+    d_data->cache.image = QImage();
+    d_data->cache.viewBox = QRectF();
+    d_data->cache.scaleX = d_data->cache.scaleY = 0.0;
+}
+
 //! Bounding rectangle of the item
 QRectF QwtPlotSvgItem::boundingRect() const
 {
@@ -157,7 +258,11 @@ void QwtPlotSvgItem::draw( QPainter *painter,
             rect = cRect;
 
         const QRectF r = QwtScaleMap::transform( xMap, yMap, rect );
-        render( painter, viewBox( rect ), r );
+
+        if ( qwtUseCache( d_data->cache.policy, painter ) )
+            renderCached( painter, viewBox( rect ), r );
+        else
+            render( painter, viewBox( rect ), r );
     }
 }
 
@@ -217,3 +322,99 @@ QRectF QwtPlotSvgItem::viewBox( const QRectF &rect ) const
 
     return QRectF( x1, y1, x2 - x1, y2 - y1 );
 }
+
+/*!
+  Render the SVG data from the tile cache
+
+  \param painter Painter
+  \param viewBox View Box, see QSvgRenderer::viewBox()
+  \param rect Target rectangle on the paint device
+
+  \sa render(), PaintCache
+*/
+void QwtPlotSvgItem::renderCached( QPainter *painter,
+    const QRectF &viewBox, const QRectF &rect ) const
+{
+    if ( !viewBox.isValid() )
+        return;
+
+    QRectF r = rect.normalized();
+
+    if ( QwtPainter::roundingAlignment( painter ) )
+    {
+        r.setLeft ( qRound( r.left() ) );
+        r.setRight ( qRound( r.right() ) );
+        r.setTop ( qRound( r.top() ) );
+        r.setBottom ( qRound( r.bottom() ) );
+    }
+
+    if ( r.isEmpty() )
+        return;
+
+    const double scaleX = r.width() / viewBox.width();
+    const double scaleY = r.height() / viewBox.height();
+
+    PrivateData::TileCache &cache = d_data->cache;
+
+    const bool isValid = !cache.image.isNull()
+        && qFuzzyCompare( cache.scaleX, scaleX )
+        && qFuzzyCompare( cache.scaleY, scaleY )
+        && cache.viewBox.contains( viewBox );
+
+    if ( !isValid )
+    {
+        // a tile with a margin of half of the visible part on each side
+
+        const double mx = 0.5 * viewBox.width();
+        const double my = 0.5 * viewBox.height();
+
+        const QRectF documentBox( QPointF( 0.0, 0.0 ),
+            QSizeF( d_data->renderer.defaultSize() ) );
+
+        QRectF tile = viewBox.adjusted( -mx, -my, mx, my ) & documentBox;
+        tile |= viewBox;
+
+        const QSize size( qCeil( tile.width() * scaleX ),
+            qCeil( tile.height() * scaleY ) );
+
+        if ( qint64( size.width() ) * size.height() > qwtMaxTileSize )
+        {
+            render( painter, viewBox, rect );
+            return;
+        }
+
+        // keeping the scale factors for the rounded image size
+        tile.setWidth( size.width() / scaleX );
+        tile.setHeight( size.height() / scaleY );
+
+        QImage image( size, QImage::Format_ARGB32_Premultiplied );
+        if ( image.isNull() )
+        {
+            render( painter, viewBox, rect );
+            return;
+        }
+
+        image.fill( 0 );
+
+        QPainter imagePainter( &image );
+        imagePainter.setRenderHints( painter->renderHints() );
+
+        d_data->renderer.setViewBox( tile );
+        d_data->renderer.render( &imagePainter,
+            QRectF( 0.0, 0.0, size.width(), size.height() ) );
+
+        imagePainter.end();
+
+        cache.image = image;
+        cache.viewBox = tile;
+        cache.scaleX = scaleX;
+        cache.scaleY = scaleY;
+    }
+
+    const QRectF sourceRect(
+        ( viewBox.left() - cache.viewBox.left() ) * cache.scaleX,
+        ( viewBox.top() - cache.viewBox.top() ) * cache.scaleY,
+        viewBox.width() * cache.scaleX, viewBox.height() * cache.scaleY );
+
+    painter->drawImage( r, cache.image, sourceRect );
+}
@@ -27,6 +27,27 @@ class QByteArray;
 class QWT_EXPORT QwtPlotSvgItem: public QwtPlotItem
 {
 public:
+    /*!
+      \brief Cache policy
+      The default policy is NoCache
+     */
+    enum CachePolicy
+    {
+        //! The SVG document is rendered each time the item is painted
+        NoCache,
+
+        /*!
+          The SVG document is rendered into an image tile, that covers the
+          visible part of the document and a margin around it. As long as
+          the scale factors don't change and the visible part is inside of
+          the tile - f.e. when panning - the item is painted from the tile.
+
+          The cache is not used for vector devices like PDF or SVG documents
+          and when painting outside of the GUI thread.
+         */
+        PaintCache
+    };
+
     explicit QwtPlotSvgItem( const QString& title = QString::null );
     explicit QwtPlotSvgItem( const QwtText& title );
     virtual ~QwtPlotSvgItem();
@@ -34,6 +55,11 @@ public:
     bool loadFile( const QRectF&, const QString &fileName );
     bool loadData( const QRectF&, const QByteArray & );
 
+    void setCachePolicy( CachePolicy );
+    CachePolicy cachePolicy() const;
+
+    void invalidateCache();
+
     virtual QRectF boundingRect() const;
 
     virtual void draw( QPainter *p,
@@ -53,6 +79,8 @@ protected:
 
 private:
     void init();
+    void renderCached( QPainter *,
+        const QRectF &viewBox, const QRectF &rect ) const;
 
     class PrivateData;
     PrivateData *d_data;
@@ -25,6 +25,69 @@ static inline bool qwtIsSampleInside( const QwtOHLCSample &sample,
     return !isOffScreen;
 }
 
+static inline QwtOHLCSample qwtTranslatedSample( const QwtOHLCSample &sample,
+    const QwtScaleMap &timeMap, const QwtScaleMap &valueMap, bool doAlign )
+{
+    QwtOHLCSample translatedSample;
+
+    translatedSample.time = timeMap.transform( sample.time );
+    translatedSample.open = valueMap.transform( sample.open );
+    translatedSample.high = valueMap.transform( sample.high );
+    translatedSample.low = valueMap.transform( sample.low );
+    translatedSample.close = valueMap.transform( sample.close );
+
+    if ( doAlign )
+    {
+        translatedSample.time = qRound( translatedSample.time );
+        translatedSample.open = qRound( translatedSample.open );
+        translatedSample.high = qRound( translatedSample.high );
+        translatedSample.low = qRound( translatedSample.low );
+        translatedSample.close = qRound( translatedSample.close );
+    }
+
+    return translatedSample;
+}
+
+namespace
+{
+    struct compareTime
+    {
+        inline bool operator()( const double time,
+            const QwtOHLCSample &sample ) const
+        {
+            return ( time < sample.time );
+        }
+    };
+}
+
+static void qwtVisibleSamples( const QwtSeriesData<QwtOHLCSample> &series,
+    double t1, double t2, int &from, int &to )
+{
+    // binary search for the samples in [t1, t2] of a series,
+    // that is sorted by time
+
+    if ( t1 > t2 )
+        qSwap( t1, t2 );
+
+    const int index1 = qwtUpperSampleIndex<QwtOHLCSample>(
+        series, t1, compareTime() );
+
+    if ( index1 < 0 )
+    {
+        // all samples are before t1
+        from = to + 1;
+        return;
+    }
+
+    from = qMax( from, index1 );
+
+    const int index2 = qwtUpperSampleIndex<QwtOHLCSample>(
+        series, t2, compareTime() );
+
+    if ( index2 >= 0 )
+        to = qMin( to, index2 - 1 );
+}
+
 class QwtPlotTradingCurve::PrivateData
 {
 public:
@@ -455,57 +518,175 @@ void QwtPlotTradingCurve::drawSymbols( QPainter *painter,
 
     painter->setPen( pen );
 
+    if ( d_data->paintAttributes & AggregateSamples )
+    {
+        // the range of pixels on the time axis, where symbols are visible
+
+        double p1, p2;
+        if ( orient == Qt::Vertical )
+        {
+            p1 = canvasRect.left();
+            p2 = canvasRect.right();
+        }
+        else
+        {
+            p1 = canvasRect.top();
+            p2 = canvasRect.bottom();
+        }
+
+        p1 -= symbolWidth;
+        p2 += symbolWidth;
+
+        qwtVisibleSamples( *data(), timeMap->invTransform( p1 ),
+            timeMap->invTransform( p2 ), from, to );
+
+        // symbols, that are overlapping, because of the minimum width
+
+        const double extentWidth = qAbs( timeMap->transform(
+            timeMap->s1() + d_data->symbolExtent ) - timeMap->p1() );
+
+        if ( extentWidth < symbolWidth )
+        {
+            drawAggregatedSymbols( painter, *timeMap, *valueMap,
+                p1, qMax( symbolWidth, 1.0 ), doAlign, from, to );
+
+            return;
+        }
+    }
+
     for ( int i = from; i <= to; i++ )
     {
         const QwtOHLCSample s = sample( i );
 
         if ( !doClip || qwtIsSampleInside( s, tMin, tMax, vMin, vMax ) )
         {
-            QwtOHLCSample translatedSample;
+            const QwtOHLCSample translatedSample = qwtTranslatedSample(
+                s, *timeMap, *valueMap, doAlign );
 
-            translatedSample.time = timeMap->transform( s.time );
-            translatedSample.open = valueMap->transform( s.open );
-            translatedSample.high = valueMap->transform( s.high );
-            translatedSample.low = valueMap->transform( s.low );
-            translatedSample.close = valueMap->transform( s.close );
+            drawSymbol( painter, translatedSample,
+                ( s.open < s.close ) ? Increasing : Decreasing,
+                orient, inverted, symbolWidth );
+        }
+    }
+}
 
-            const int brushIndex = ( s.open < s.close )
-                ? QwtPlotTradingCurve::Increasing
-                : QwtPlotTradingCurve::Decreasing;
+/*!
+  Draw symbols for columns of samples
 
-            if ( doAlign )
+  Consecutive samples in the same column are merged to one sample:
+  the open value of the first, the maximum of the high values, the minimum
+  of the low values and the close value of the last sample.
+
+  \param painter Painter
+  \param timeMap Maps time values into paint device coordinates.
+  \param valueMap Maps values into paint device coordinates.
+  \param origin Position of the first column in paint device coordinates
+  \param columnWidth Width of a column in paint device coordinates
+  \param doAlign Round all coordinates to integers
+  \param from Index of the first sample to be painted
+  \param to Index of the last sample to be painted
+
+  \sa drawSymbols(), AggregateSamples
+ */
+void QwtPlotTradingCurve::drawAggregatedSymbols( QPainter *painter,
+    const QwtScaleMap &timeMap, const QwtScaleMap &valueMap,
+    double origin, double columnWidth, bool doAlign, int from, int to ) const
+{
+    const Qt::Orientation orient = orientation();
+    const bool inverted = timeMap.isInverting();
+
+    const double symbolWidth = doAlign
+        ? qFloor( 0.5 * columnWidth ) * 2.0 : columnWidth;
+
+    QwtOHLCSample merged;
+    double column = 0.0;
+    bool isPending = false;
+
+    for ( int i = from; i <= to + 1; i++ )
+    {
+        QwtOHLCSample s;
+        double c = 0.0;
+
+        if ( i <= to )
+        {
+            s = sample( i );
+
+            const double pos = timeMap.transform( s.time );
+            c = qFloor( ( pos - origin ) / columnWidth );
+
+            if ( isPending && c == column )
             {
-                translatedSample.time = qRound( translatedSample.time );
-                translatedSample.open = qRound( translatedSample.open );
-                translatedSample.high = qRound( translatedSample.high );
-                translatedSample.low = qRound( translatedSample.low );
-                translatedSample.close = qRound( translatedSample.close );
+                merged.high = qMax( merged.high, s.high );
+                merged.low = qMin( merged.low, s.low );
+                merged.close = s.close;
+
+                continue;
             }
+        }
+
+        if ( isPending )
+        {
+            QwtOHLCSample translatedSample = qwtTranslatedSample(
+                merged, timeMap, valueMap, doAlign );
+
+            // the center of the column
+            translatedSample.time = origin + ( column + 0.5 ) * columnWidth;
+            if ( doAlign )
+                translatedSample.time = qRound( translatedSample.time );
 
-            switch( d_data->symbolStyle )
+            drawSymbol( painter, translatedSample,
+                ( merged.open < merged.close ) ? Increasing : Decreasing,
+                orient, inverted, symbolWidth );
+        }
+
+        if ( i <= to )
+        {
+            merged = s;
+            column = c;
+            isPending = true;
+        }
+    }
+}
+
+/*!
+  Draw a symbol for a sample, that has been translated
+  into paint device coordinates
+
+  \param painter Qt painter, initialized with the pen
+  \param translatedSample Sample in paint device coordinates
+  \param brushIndex Increasing or Decreasing
+  \param orientation Vertical or horizontal
+  \param inverted True, when the opposite scale
+                  ( Qt::Vertical: x, Qt::Horizontal: y ) is increasing
+                  in the opposite direction as QPainter coordinates.
+  \param symbolWidth Width of the symbol in paint device coordinates
+ */
+void QwtPlotTradingCurve::drawSymbol( QPainter *painter,
+    const QwtOHLCSample &translatedSample, int brushIndex,
+    Qt::Orientation orientation, bool inverted, double symbolWidth ) const
+{
+    switch( d_data->symbolStyle )
+    {
+        case Bar:
+        {
+            drawBar( painter, translatedSample,
+                orientation, inverted, symbolWidth );
+            break;
+        }
+        case CandleStick:
+        {
+            painter->setBrush( d_data->symbolBrush[ brushIndex ] );
+            drawCandleStick( painter, translatedSample,
+                orientation, symbolWidth );
+            break;
+        }
+        default:
+        {
+            if ( d_data->symbolStyle >= UserSymbol )
             {
-                case Bar:
-                {
-                    drawBar( painter, translatedSample, 
-                        orient, inverted, symbolWidth );
-                    break;
-                }
-                case CandleStick:
-                {
-                    painter->setBrush( d_data->symbolBrush[ brushIndex ] );
-                    drawCandleStick( painter, translatedSample, 
-                        orient, symbolWidth );
-                    break;
-                }
-                default:
-                {
-                    if ( d_data->symbolStyle >= UserSymbol )
-                    {
-                        painter->setBrush( d_data->symbolBrush[ brushIndex ] );
-                        drawUserSymbol( painter, d_data->symbolStyle,
-                            translatedSample, orient, inverted, symbolWidth );
-                    }
-                }
+                painter->setBrush( d_data->symbolBrush[ brushIndex ] );
+                drawUserSymbol( painter, d_data->symbolStyle,
+                    translatedSample, orientation, inverted, symbolWidth );
             }
         }
     }
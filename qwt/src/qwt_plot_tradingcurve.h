@@ -95,7 +95,22 @@ public:
     enum PaintAttribute
     {
         //! Check if a symbol is on the plot canvas before painting it.
-        ClipSymbols   = 0x01
+        ClipSymbols   = 0x01,
+
+        /*!
+          Samples, that are mapped to the same column of the
+          canvas, are merged into one symbol: the open value of the first,
+          the maximum of the high values, the minimum of the low values
+          and the close value of the last sample.
+
+          Aggregation happens only, when the symbols of the samples would
+          overlap because of the minimum symbol width. The visible samples
+          are found by a binary search, so the samples need to be
+          sorted in increasing order of time.
+
+          \sa minSymbolWidth()
+         */
+        AggregateSamples = 0x02
     };
 
     //! Paint attributes
@@ -165,6 +180,14 @@ protected:
         const QRectF &canvasRect ) const;
 
 private:
+    void drawAggregatedSymbols( QPainter *,
+        const QwtScaleMap &timeMap, const QwtScaleMap &valueMap,
+        double origin, double columnWidth, bool doAlign,
+        int from, int to ) const;
+
+    void drawSymbol( QPainter *, const QwtOHLCSample &, int brushIndex,
+        Qt::Orientation, bool inverted, double symbolWidth ) const;
+
     class PrivateData;
     PrivateData *d_data;
 };
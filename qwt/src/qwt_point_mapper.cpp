@@ -10,6 +10,8 @@
 #include "qwt_point_mapper.h"
 #include "qwt_scale_map.h"
 #include "qwt_pixel_matrix.h"
+#include "qwt_plot_profile.h"
+#include "qwt_scratch_pool.h"
 #include <qpolygon.h>
 #include <qimage.h>
 #include <qpen.h>
@@ -40,6 +42,15 @@ static inline double qwtRoundValueF( double value )
 #endif
 }
 
+static inline void qwtProfilePoints( int from, int to, int numPoints )
+{
+    if ( QwtPlotProfiler::isActive() )
+    {
+        QwtPlotProfiler::count( QwtPlotProfiler::PointsIn, to - from + 1 );
+        QwtPlotProfiler::count( QwtPlotProfiler::PointsOut, numPoints );
+    }
+}
+
 static Qt::Orientation qwtProbeOrientation(
     const QwtSeriesData<QPointF> *series, int from, int to )
 {
@@ -272,6 +283,89 @@ static Polygon qwtMapPointsQuad( const QwtScaleMap &xMap, const QwtScaleMap &yMa
     return polyline;
 }
 
+template <class Polygon, class PolygonQuadrupel>
+static inline void qwtAppendQuad( PolygonQuadrupel &q,
+    int x, int y, Polygon &polyline )
+{
+    if ( !q.append( x, y ) )
+    {
+        q.flush( polyline );
+        q.start( x, y );
+    }
+}
+
+template <class Polygon, class Point, class PolygonQuadrupel>
+static Polygon qwtMapStepsQuad( const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QwtSeriesData<QPointF> *series, int from, int to, bool inverted )
+{
+    const QPointF sample0 = series->sample( from );
+
+    int x0 = qwtRoundValue( xMap.transform( sample0.x() ) );
+    int y0 = qwtRoundValue( yMap.transform( sample0.y() ) );
+
+    PolygonQuadrupel q;
+    q.start( x0, y0 );
+
+    Polygon polyline;
+    for ( int i = from + 1; i <= to; i++ )
+    {
+        const QPointF sample = series->sample( i );
+
+        const int x = qwtRoundValue( xMap.transform( sample.x() ) );
+        const int y = qwtRoundValue( yMap.transform( sample.y() ) );
+
+        // the corner of the step
+        if ( inverted )
+            qwtAppendQuad( q, x0, y, polyline );
+        else
+            qwtAppendQuad( q, x, y0, polyline );
+
+        qwtAppendQuad( q, x, y, polyline );
+
+        x0 = x;
+        y0 = y;
+    }
+    q.flush( polyline );
+
+    return polyline;
+}
+
+template <class Polygon, class Point>
+static Polygon qwtMapStepsQuad( const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QwtSeriesData<QPointF> *series, int from, int to, bool inverted )
+{
+    Polygon polyline;
+    if ( from > to )
+        return polyline;
+
+    // the steps are a polyline, where all corners of a chunk of
+    // samples are mapped to the same column ( or row ). So it can
+    // be reduced like the polyline of the samples
+
+    const Qt::Orientation orientation = qwtProbeOrientation( series, from, to );
+
+    if ( orientation == Qt::Horizontal )
+    {
+        polyline = qwtMapStepsQuad< Polygon, Point,
+            QwtPolygonQuadrupelY<Polygon, Point> >(
+                xMap, yMap, series, from, to, inverted );
+
+        polyline = qwtMapPointsQuad< Polygon, Point,
+            QwtPolygonQuadrupelX<Polygon, Point> >( polyline );
+    }
+    else
+    {
+        polyline = qwtMapStepsQuad< Polygon, Point,
+            QwtPolygonQuadrupelX<Polygon, Point> >(
+                xMap, yMap, series, from, to, inverted );
+
+        polyline = qwtMapPointsQuad< Polygon, Point,
+            QwtPolygonQuadrupelY<Polygon, Point> >( polyline );
+    }
+
+    return polyline;
+}
+
 // Helper class to work around the 5 parameters
 // limitation of QtConcurrent::run()
 class QwtDotsCommand
@@ -343,7 +437,7 @@ static inline Polygon qwtToPoints(
     const QwtSeriesData<QPointF> *series, 
     int from, int to, Round round )
 {
-    Polygon polyline( to - from + 1 );
+    Polygon polyline = qwtScratchPolygon<Polygon>( to - from + 1 );
     Point *points = polyline.data();
 
     int numPoints = 0;
@@ -429,7 +523,7 @@ static inline Polygon qwtToPolylineFiltered(
     // result in empty lines ( or symbols hidden by others )
     // we try to filter them out
 
-    Polygon polyline( to - from + 1 );
+    Polygon polyline = qwtScratchPolygon<Polygon>( to - from + 1 );
     Point *points = polyline.data();
 
     const QPointF sample0 = series->sample( from );
@@ -481,7 +575,7 @@ static inline Polygon qwtToPointsFiltered(
     // F.e. in scatter plots ( no connecting lines ) we
     // can sort out all duplicates ( not only consecutive points )
 
-    Polygon polygon( to - from + 1 );
+    Polygon polygon = qwtScratchPolygon<Polygon>( to - from + 1 );
     Point *points = polygon.data();
 
     QwtPixelMatrix pixelMatrix( boundingRect.toAlignedRect() );
@@ -525,6 +619,153 @@ static inline QPolygonF qwtToPointsFilteredF(
         boundingRect, xMap, yMap, series, from, to );
 }
 
+// Mapping the corners of a step function
+
+template<class Round>
+static inline QPolygonF qwtToStepsF(
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QwtSeriesData<QPointF> *series, int from, int to,
+    bool inverted, bool weedOut, Round round )
+{
+    QPolygonF polyline = QwtScratchPool::take( 2 * ( to - from ) + 1 );
+    QPointF *points = polyline.data();
+
+    const QPointF sample0 = series->sample( from );
+
+    points[0].rx() = round( xMap.transform( sample0.x() ) );
+    points[0].ry() = round( yMap.transform( sample0.y() ) );
+
+    int pos = 0;
+    for ( int i = from + 1; i <= to; i++ )
+    {
+        const QPointF sample = series->sample( i );
+
+        const QPointF p( round( xMap.transform( sample.x() ) ),
+            round( yMap.transform( sample.y() ) ) );
+
+        if ( weedOut && p == points[pos] )
+            continue;
+
+        const QPointF &p0 = points[pos];
+
+        const QPointF corner = inverted
+            ? QPointF( p0.x(), p.y() ) : QPointF( p.x(), p0.y() );
+
+        if ( !weedOut || ( corner != p0 && corner != p ) )
+            points[++pos] = corner;
+
+        points[++pos] = p;
+    }
+
+    polyline.resize( pos + 1 );
+    return polyline;
+}
+
+// Mapping sticks: pairs of points from the baseline to the samples
+
+template<class Round>
+static inline QPolygonF qwtToSticksF(
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QwtSeriesData<QPointF> *series, int from, int to,
+    Qt::Orientation orientation, double baseline, bool weedOut, Round round )
+{
+    QPolygonF sticks = QwtScratchPool::take( 2 * ( to - from + 1 ) );
+    QPointF *points = sticks.data();
+
+    const double x0 = round( xMap.transform( baseline ) );
+    const double y0 = round( yMap.transform( baseline ) );
+
+    int numPoints = 0;
+    for ( int i = from; i <= to; i++ )
+    {
+        const QPointF sample = series->sample( i );
+
+        const QPointF p( round( xMap.transform( sample.x() ) ),
+            round( yMap.transform( sample.y() ) ) );
+
+        // consecutive sticks to the same position are identical
+        if ( weedOut && numPoints > 0 && points[numPoints - 1] == p )
+            continue;
+
+        if ( orientation == Qt::Horizontal )
+            points[numPoints++] = QPointF( x0, p.y() );
+        else
+            points[numPoints++] = QPointF( p.x(), y0 );
+
+        points[numPoints++] = p;
+    }
+
+    sticks.resize( numPoints );
+    return sticks;
+}
+
+static inline void qwtAppendStick( QPolygonF &sticks,
+    Qt::Orientation orientation, int pos, int min, int max )
+{
+    if ( orientation == Qt::Horizontal )
+    {
+        sticks += QPointF( min, pos );
+        sticks += QPointF( max, pos );
+    }
+    else
+    {
+        sticks += QPointF( pos, min );
+        sticks += QPointF( pos, max );
+    }
+}
+
+static QPolygonF qwtToSticksMerged(
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QwtSeriesData<QPointF> *series, int from, int to,
+    Qt::Orientation orientation, double baseline )
+{
+    // A chunk of consecutive sticks, that is mapped to the same
+    // row ( or column ), is painted as one stick covering all of them.
+
+    QPolygonF sticks;
+    if ( from > to )
+        return sticks;
+
+    const bool isHorizontal = ( orientation == Qt::Horizontal );
+
+    const int base = isHorizontal
+        ? qwtRoundValue( xMap.transform( baseline ) )
+        : qwtRoundValue( yMap.transform( baseline ) );
+
+    int pos = 0;
+    int min = base;
+    int max = base;
+
+    for ( int i = from; i <= to; i++ )
+    {
+        const QPointF sample = series->sample( i );
+
+        const int x = qwtRoundValue( xMap.transform( sample.x() ) );
+        const int y = qwtRoundValue( yMap.transform( sample.y() ) );
+
+        const int p = isHorizontal ? y : x;
+        const int value = isHorizontal ? x : y;
+
+        if ( i == from || p != pos )
+        {
+            if ( i != from )
+                qwtAppendStick( sticks, orientation, pos, min, max );
+
+            pos = p;
+            min = max = base;
+        }
+
+        if ( value < min )
+            min = value;
+        else if ( value > max )
+            max = value;
+    }
+
+    qwtAppendStick( sticks, orientation, pos, min, max );
+
+    return sticks;
+}
+
 class QwtPointMapper::PrivateData
 {
 public:
@@ -642,6 +883,8 @@ QPolygonF QwtPointMapper::toPolygonF(
     const QwtScaleMap &xMap, const QwtScaleMap &yMap,
     const QwtSeriesData<QPointF> *series, int from, int to ) const
 {
+    QwtPlotProfiler::Timer timer( QwtPlotProfiler::Mapping );
+
     QPolygonF polyline;
 
     if ( d_data->flags & RoundPoints )
@@ -676,6 +919,8 @@ QPolygonF QwtPointMapper::toPolygonF(
         }
     }
 
+    qwtProfilePoints( from, to, polyline.size() );
+
     return polyline;
 }
 
@@ -697,6 +942,8 @@ QPolygon QwtPointMapper::toPolygon(
     const QwtScaleMap &xMap, const QwtScaleMap &yMap,
     const QwtSeriesData<QPointF> *series, int from, int to ) const
 {
+    QwtPlotProfiler::Timer timer( QwtPlotProfiler::Mapping );
+
     QPolygon polyline;
 
     if ( d_data->flags & WeedOutIntermediatePoints )
@@ -716,6 +963,8 @@ QPolygon QwtPointMapper::toPolygon(
             qwtInvalidRect, xMap, yMap, series, from, to );
     }
 
+    qwtProfilePoints( from, to, polyline.size() );
+
     return polyline;
 }
 
@@ -754,6 +1003,8 @@ QPolygonF QwtPointMapper::toPointsF(
     const QwtScaleMap &xMap, const QwtScaleMap &yMap,
     const QwtSeriesData<QPointF> *series, int from, int to ) const
 {
+    QwtPlotProfiler::Timer timer( QwtPlotProfiler::Mapping );
+
     QPolygonF points;
 
     if ( d_data->flags & WeedOutPoints )
@@ -798,6 +1049,8 @@ QPolygonF QwtPointMapper::toPointsF(
         }
     }
 
+    qwtProfilePoints( from, to, points.size() );
+
     return points;
 }
 
@@ -828,6 +1081,8 @@ QPolygon QwtPointMapper::toPoints(
     const QwtScaleMap &xMap, const QwtScaleMap &yMap,
     const QwtSeriesData<QPointF> *series, int from, int to ) const
 {
+    QwtPlotProfiler::Timer timer( QwtPlotProfiler::Mapping );
+
     QPolygon points;
 
     if ( d_data->flags & WeedOutPoints )
@@ -852,10 +1107,139 @@ QPolygon QwtPointMapper::toPoints(
             d_data->boundingRect, xMap, yMap, series, from, to );
     }
 
+    qwtProfilePoints( from, to, points.size() );
+
     return points;
 }
 
 
+/*!
+  \brief Translate a series of points into the polyline of a step function
+
+  Each sample is connected to its predecessor by a horizontal
+  and a vertical line.
+
+  When the WeedOutPoints flag is enabled consecutive points,
+  that are mapped to the same position, will be one point.
+
+  When RoundPoints & WeedOutIntermediatePoints is enabled the steps are
+  reduced like in toPolygonF(): all corners of a chunk of samples being
+  mapped to the same x ( or y ) coordinate are reduced to 4 points.
+  So the number of points is limited by the size of the paint device,
+  not by the number of samples.
+
+  \param xMap x map
+  \param yMap y map
+  \param series Series of points to be mapped
+  \param from Index of the first point to be painted
+  \param to Index of the last point to be painted
+  \param inverted When inverted the vertical line of a step
+                  is drawn before the horizontal line.
+
+  \return Translated polyline
+  \sa QwtPlotCurve::Steps, QwtPlotCurve::Inverted
+*/
+QPolygonF QwtPointMapper::toStepsF(
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QwtSeriesData<QPointF> *series, int from, int to,
+    bool inverted ) const
+{
+    QwtPlotProfiler::Timer timer( QwtPlotProfiler::Mapping );
+
+    QPolygonF polyline;
+    if ( from > to )
+        return polyline;
+
+    const bool weedOut = d_data->flags & WeedOutPoints;
+
+    if ( d_data->flags & RoundPoints )
+    {
+        if ( d_data->flags & WeedOutIntermediatePoints )
+        {
+            polyline = qwtMapStepsQuad<QPolygonF, QPointF>(
+                xMap, yMap, series, from, to, inverted );
+        }
+        else
+        {
+            polyline = qwtToStepsF( xMap, yMap, series, from, to,
+                inverted, weedOut, QwtRoundF() );
+        }
+    }
+    else
+    {
+        polyline = qwtToStepsF( xMap, yMap, series, from, to,
+            inverted, weedOut, QwtNoRoundF() );
+    }
+
+    qwtProfilePoints( from, to, polyline.size() );
+
+    return polyline;
+}
+
+/*!
+  \brief Translate a series of points into sticks
+
+  A stick is a line from the baseline to a point. The sticks are returned
+  as pairs of points, that can be painted by QPainter::drawLines().
+
+  When the WeedOutPoints flag is enabled consecutive points,
+  that are mapped to the same position, will be one stick.
+
+  When RoundPoints & WeedOutIntermediatePoints is enabled all consecutive
+  sticks being mapped to the same row ( or column ) are merged into
+  one stick covering all of them. For sticks painted without antialiasing
+  the result is identical, but the number of sticks is limited by the
+  size of the paint device.
+
+  \param xMap x map
+  \param yMap y map
+  \param series Series of points to be mapped
+  \param from Index of the first point to be painted
+  \param to Index of the last point to be painted
+  \param orientation Qt::Horizontal for horizontal sticks from a vertical
+                     baseline, Qt::Vertical for vertical sticks
+  \param baseline Value of the baseline
+
+  \return Pairs of points
+  \sa QwtPlotCurve::Sticks
+*/
+QPolygonF QwtPointMapper::toSticksF(
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QwtSeriesData<QPointF> *series, int from, int to,
+    Qt::Orientation orientation, double baseline ) const
+{
+    QwtPlotProfiler::Timer timer( QwtPlotProfiler::Mapping );
+
+    QPolygonF sticks;
+    if ( from > to )
+        return sticks;
+
+    const bool weedOut = d_data->flags & WeedOutPoints;
+
+    if ( d_data->flags & RoundPoints )
+    {
+        if ( d_data->flags & WeedOutIntermediatePoints )
+        {
+            sticks = qwtToSticksMerged( xMap, yMap, series,
+                from, to, orientation, baseline );
+        }
+        else
+        {
+            sticks = qwtToSticksF( xMap, yMap, series, from, to,
+                orientation, baseline, weedOut, QwtRoundF() );
+        }
+    }
+    else
+    {
+        sticks = qwtToSticksF( xMap, yMap, series, from, to,
+            orientation, baseline, weedOut, QwtNoRoundF() );
+    }
+
+    qwtProfilePoints( from, to, sticks.size() );
+
+    return sticks;
+}
+
 /*!
   \brief Translate a series into a QImage
 
@@ -46,7 +46,7 @@ public:
 
         /*!
           An even more aggressive weeding algorithm, that
-          can be used in toPolygon().
+          can be used in toPolygon(), toStepsF() and toSticksF().
 
           A consecutive chunk of points being mapped to the
           same x coordinate is reduced to 4 points:
@@ -95,6 +95,14 @@ public:
     QPolygonF toPointsF( const QwtScaleMap &xMap, const QwtScaleMap &yMap,
         const QwtSeriesData<QPointF> *series, int from, int to ) const;
 
+    QPolygonF toStepsF( const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QwtSeriesData<QPointF> *series, int from, int to,
+        bool inverted ) const;
+
+    QPolygonF toSticksF( const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QwtSeriesData<QPointF> *series, int from, int to,
+        Qt::Orientation, double baseline ) const;
+
     QImage toImage( const QwtScaleMap &xMap, const QwtScaleMap &yMap,
         const QwtSeriesData<QPointF> *series, int from, int to, 
         const QPen &, bool antialiased, uint numThreads ) const;
@@ -0,0 +1,249 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_scratch_pool.h"
+#include "qwt_plot_profile.h"
+#include <qlist.h>
+#include <qthreadstorage.h>
+
+namespace
+{
+    enum
+    {
+        // the smallest pooled buffer has 2^MinClass points
+        MinClass = 10,
+
+        // the largest pooled buffer has 2^MaxClass points
+        MaxClass = 26,
+
+        NumClasses = MaxClass - MinClass + 1,
+
+        // maximum number of free buffers of a size class
+        MaxBuffers = 2
+    };
+}
+
+static qint64 qwtMaxBytes = 64 * 1024 * 1024;
+
+class QwtScratchContext
+{
+public:
+    QwtScratchContext():
+        retainedBytes( 0 )
+    {
+    }
+
+    QList<QPolygonF> buffers[NumClasses];
+    qint64 retainedBytes;
+};
+
+/*
+   QThreadStorage of Qt4 takes ownership of its data. So the
+   buffers of a thread are freed, when the thread terminates.
+ */
+static QThreadStorage<QwtScratchContext *> qwtScratchContext;
+
+static inline QwtScratchContext *qwtContext()
+{
+    if ( !qwtScratchContext.hasLocalData() )
+        qwtScratchContext.setLocalData( new QwtScratchContext() );
+
+    return qwtScratchContext.localData();
+}
+
+static inline qint64 qwtBytes( int numPoints )
+{
+    return qint64( numPoints ) * sizeof( QPointF );
+}
+
+static inline int qwtCapacity( int index )
+{
+    return 1 << ( index + MinClass );
+}
+
+// index of the smallest class, that can hold size points,
+// or NumClasses, when size exceeds all classes
+static inline int qwtClassIndex( int size )
+{
+    int index = 0;
+    while ( index < NumClasses && qwtCapacity( index ) < size )
+        index++;
+
+    return index;
+}
+
+static void qwtEvict( QwtScratchContext *context, qint64 bytes )
+{
+    // freeing the largest buffers first
+
+    for ( int index = NumClasses - 1; index >= 0; index-- )
+    {
+        QList<QPolygonF> &buffers = context->buffers[index];
+
+        while ( !buffers.isEmpty() )
+        {
+            if ( context->retainedBytes + bytes <= qwtMaxBytes )
+                return;
+
+            context->retainedBytes -= qwtBytes( buffers.last().capacity() );
+            buffers.removeLast();
+        }
+    }
+}
+
+/*!
+  \brief Take a buffer from the pool of the calling thread
+
+  When the pool has a buffer of the size class it is reused,
+  otherwise a new buffer with the capacity of the size class
+  is allocated.
+
+  \param size Number of points
+  \return Polygon of size points. The values of the points are undefined.
+
+  \sa release()
+ */
+QPolygonF QwtScratchPool::take( int size )
+{
+    if ( size < minimumSize() || size > qwtCapacity( NumClasses - 1 ) )
+        return QPolygonF( size );
+
+    QwtScratchContext *context = qwtContext();
+
+    const int index = qwtClassIndex( size );
+    QList<QPolygonF> &buffers = context->buffers[index];
+
+    QPolygonF polygon;
+
+    if ( !buffers.isEmpty() )
+    {
+        polygon = buffers.takeLast();
+        context->retainedBytes -= qwtBytes( polygon.capacity() );
+
+        QwtPlotProfiler::count( QwtPlotProfiler::ScratchReused,
+            qwtBytes( polygon.capacity() ) );
+    }
+    else
+    {
+        polygon.reserve( qwtCapacity( index ) );
+
+        QwtPlotProfiler::count( QwtPlotProfiler::ScratchAllocated,
+            qwtBytes( polygon.capacity() ) );
+    }
+
+    polygon.resize( size );
+    return polygon;
+}
+
+/*!
+  \brief Return a buffer to the pool of the calling thread
+
+  The polygon is cleared. Its buffer is kept for the following
+  calls of take(), unless it is too small, shared with another
+  polygon or does not fit into the limit of maxBytes().
+
+  \param polygon Polygon, that is not needed anymore
+  \sa take(), trim()
+ */
+void QwtScratchPool::release( QPolygonF &polygon )
+{
+    QPolygonF buffer = polygon;
+    polygon = QPolygonF();
+
+    const int capacity = buffer.capacity();
+    if ( capacity < minimumSize() || !buffer.isDetached() )
+        return;
+
+    // the largest class, that is covered by the buffer
+
+    int index = qwtClassIndex( capacity );
+    if ( index == NumClasses || qwtCapacity( index ) > capacity )
+        index--;
+
+    QwtScratchContext *context = qwtContext();
+
+    QList<QPolygonF> &buffers = context->buffers[index];
+    if ( buffers.size() >= MaxBuffers )
+        return;
+
+    const qint64 bytes = qwtBytes( capacity );
+    if ( bytes > qwtMaxBytes )
+        return;
+
+    if ( context->retainedBytes + bytes > qwtMaxBytes )
+        qwtEvict( context, bytes );
+
+    // a reserved capacity is not given up, when shrinking
+    buffer.reserve( capacity );
+    buffer.resize( 0 );
+
+    buffers += buffer;
+    context->retainedBytes += bytes;
+
+    QwtPlotProfiler::count( QwtPlotProfiler::ScratchPeak,
+        context->retainedBytes );
+}
+
+/*!
+  Free all buffers of the pool of the calling thread
+  \sa retainedBytes()
+ */
+void QwtScratchPool::trim()
+{
+    if ( !qwtScratchContext.hasLocalData() )
+        return;
+
+    QwtScratchContext *context = qwtScratchContext.localData();
+
+    for ( int i = 0; i < NumClasses; i++ )
+        context->buffers[i].clear();
+
+    context->retainedBytes = 0;
+}
+
+/*!
+  \brief Set the limit for the memory retained by the pool of a thread
+
+  The limit is shared by all threads and should be set before
+  any rendering takes place. The default setting is 64MB.
+
+  \param bytes Limit in bytes
+  \sa maxBytes(), trim()
+ */
+void QwtScratchPool::setMaxBytes( qint64 bytes )
+{
+    qwtMaxBytes = qMax( bytes, qint64( 0 ) );
+}
+
+/*!
+  \return Limit for the memory retained by the pool of a thread
+  \sa setMaxBytes()
+ */
+qint64 QwtScratchPool::maxBytes()
+{
+    return qwtMaxBytes;
+}
+
+/*!
+  \return Memory retained by the free buffers of the calling thread
+  \sa trim()
+ */
+qint64 QwtScratchPool::retainedBytes()
+{
+    if ( !qwtScratchContext.hasLocalData() )
+        return 0;
+
+    return qwtScratchContext.localData()->retainedBytes;
+}
+
+//! \return Minimum number of points of a buffer, that is pooled
+int QwtScratchPool::minimumSize()
+{
+    return qwtCapacity( 0 );
+}
@@ -0,0 +1,87 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_SCRATCH_POOL_H
+#define QWT_SCRATCH_POOL_H 1
+
+#include "qwt_global.h"
+#include <qpolygon.h>
+
+/*!
+  \brief Pool of buffers for temporary polygons
+
+  Rendering a series with many points needs large temporary polygons,
+  f.e. for the translated points or the result of the clipper. Allocating
+  and freeing them for each replot results in expensive malloc/free
+  cycles and page faults.
+
+  QwtScratchPool keeps released buffers in size classes ( powers of 2 ),
+  so that the following request of a similar size can reuse them.
+  Each thread has its own pool, so no locking is involved.
+
+  Buffers below minimumSize() are not pooled, as small allocations are
+  cheap. The memory retained by the pool of a thread is limited
+  by maxBytes(): when releasing a buffer would exceed the limit,
+  the largest buffers of the pool are freed. trim() frees all buffers
+  of the calling thread and might be called under memory pressure.
+
+  \par Example
+  \verbatim
+QPolygonF points = QwtScratchPool::take( numPoints );
+...
+painter->drawPolyline( points );
+QwtScratchPool::release( points );
+\endverbatim
+
+  \note A buffer is only recycled, when it is not shared with
+        another QPolygonF.
+
+  \sa QwtPlotProfile::ItemRecord::scratchBytesReused
+ */
+class QWT_EXPORT QwtScratchPool
+{
+public:
+    static QPolygonF take( int size );
+    static void release( QPolygonF & );
+
+    static void trim();
+
+    static void setMaxBytes( qint64 );
+    static qint64 maxBytes();
+
+    static qint64 retainedBytes();
+
+    static int minimumSize();
+
+private:
+    QwtScratchPool();
+};
+
+/*!
+  \brief Allocate a polygon for temporary use
+
+  Polygons of type QPolygonF are taken from QwtScratchPool,
+  all others are allocated.
+
+  \param size Number of points
+  \return Polygon of size points
+ */
+template <class Polygon>
+inline Polygon qwtScratchPolygon( int size )
+{
+    return Polygon( size );
+}
+
+template <>
+inline QPolygonF qwtScratchPolygon<QPolygonF>( int size )
+{
+    return QwtScratchPool::take( size );
+}
+
+#endif
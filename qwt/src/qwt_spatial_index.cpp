@@ -0,0 +1,441 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_spatial_index.h"
+#include "qwt_scale_map.h"
+#include "qwt_math.h"
+#include <qrect.h>
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+    class IndexedPoint
+    {
+    public:
+        double x;
+        double y;
+        int index;
+    };
+
+    class LessX
+    {
+    public:
+        inline bool operator()( const IndexedPoint &p1,
+            const IndexedPoint &p2 ) const
+        {
+            return p1.x < p2.x;
+        }
+    };
+
+    class LessY
+    {
+    public:
+        inline bool operator()( const IndexedPoint &p1,
+            const IndexedPoint &p2 ) const
+        {
+            return p1.y < p2.y;
+        }
+    };
+
+    /*
+      Candidates of a nearest neighbour search, sorted by
+      their squared distance. As the number of requested points
+      is usually small, a sorted vector is good enough.
+     */
+    class Candidates
+    {
+    public:
+        explicit Candidates( int capacity ):
+            d_capacity( capacity )
+        {
+            d_entries.reserve( capacity + 1 );
+        }
+
+        inline double worstDistance() const
+        {
+            if ( d_entries.size() < d_capacity )
+                return std::numeric_limits<double>::max();
+
+            return d_entries.last().distance;
+        }
+
+        void insert( double distance, int index )
+        {
+            // NaNs would break the order of the entries
+            if ( !qIsFinite( distance ) || distance >= worstDistance() )
+                return;
+
+            int i = d_entries.size();
+            while ( i > 0 && d_entries[i - 1].distance > distance )
+                i--;
+
+            const Entry entry = { distance, index };
+            d_entries.insert( i, entry );
+
+            if ( d_entries.size() > d_capacity )
+                d_entries.removeLast();
+        }
+
+        int size() const
+        {
+            return d_entries.size();
+        }
+
+        int index( int i ) const
+        {
+            return d_entries[i].index;
+        }
+
+        double distance( int i ) const
+        {
+            return d_entries[i].distance;
+        }
+
+    private:
+        struct Entry
+        {
+            double distance;
+            int index;
+        };
+
+        const int d_capacity;
+        QVector<Entry> d_entries;
+    };
+}
+
+static void qwtBuildTree( IndexedPoint *begin, IndexedPoint *end, int depth )
+{
+    // an implicit tree: the median of each range is its node
+
+    while ( end - begin > 1 )
+    {
+        IndexedPoint *mid = begin + ( end - begin ) / 2;
+
+        if ( depth % 2 == 0 )
+            std::nth_element( begin, mid, end, LessX() );
+        else
+            std::nth_element( begin, mid, end, LessY() );
+
+        qwtBuildTree( begin, mid, depth + 1 );
+
+        begin = mid + 1;
+        depth++;
+    }
+}
+
+class QwtSpatialIndex::PrivateData
+{
+public:
+    PrivateData():
+        isBuilt( false )
+    {
+    }
+
+    bool isBuilt;
+    QVector<IndexedPoint> points;
+};
+
+namespace
+{
+    class NearestSearch
+    {
+    public:
+        NearestSearch( const IndexedPoint *points,
+                const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+                const QPointF &pos, int numPoints ):
+            d_points( points ),
+            d_xMap( xMap ),
+            d_yMap( yMap ),
+            d_pos( pos ),
+            d_posX( xMap.invTransform( pos.x() ) ),
+            d_posY( yMap.invTransform( pos.y() ) ),
+            candidates( numPoints )
+        {
+        }
+
+        void search( int begin, int end, int depth )
+        {
+            if ( begin >= end )
+                return;
+
+            const int mid = begin + ( end - begin ) / 2;
+            const IndexedPoint &p = d_points[mid];
+
+            const double dx = d_xMap.transform( p.x ) - d_pos.x();
+            const double dy = d_yMap.transform( p.y ) - d_pos.y();
+
+            candidates.insert( dx * dx + dy * dy, p.index );
+
+            // the splitting line in paint device coordinates
+
+            bool lower;
+            double distance;
+
+            if ( depth % 2 == 0 )
+            {
+                lower = d_posX < p.x;
+                distance = dx;
+            }
+            else
+            {
+                lower = d_posY < p.y;
+                distance = dy;
+            }
+
+            if ( lower )
+            {
+                search( begin, mid, depth + 1 );
+                if ( distance * distance < candidates.worstDistance() )
+                    search( mid + 1, end, depth + 1 );
+            }
+            else
+            {
+                search( mid + 1, end, depth + 1 );
+                if ( distance * distance < candidates.worstDistance() )
+                    search( begin, mid, depth + 1 );
+            }
+        }
+
+    private:
+        const IndexedPoint *d_points;
+
+        const QwtScaleMap &d_xMap;
+        const QwtScaleMap &d_yMap;
+
+        const QPointF d_pos;
+
+        // the position in plot coordinates
+        const double d_posX;
+        const double d_posY;
+
+    public:
+        Candidates candidates;
+    };
+}
+
+static void qwtRectSearch( const IndexedPoint *points,
+    int begin, int end, int depth, const QRectF &rect, QVector<int> &indexes )
+{
+    while ( begin < end )
+    {
+        const int mid = begin + ( end - begin ) / 2;
+        const IndexedPoint &p = points[mid];
+
+        if ( p.x >= rect.left() && p.x <= rect.right()
+            && p.y >= rect.top() && p.y <= rect.bottom() )
+        {
+            indexes += p.index;
+        }
+
+        double min, max, value;
+        if ( depth % 2 == 0 )
+        {
+            min = rect.left();
+            max = rect.right();
+            value = p.x;
+        }
+        else
+        {
+            min = rect.top();
+            max = rect.bottom();
+            value = p.y;
+        }
+
+        depth++;
+
+        if ( min <= value )
+        {
+            if ( max >= value )
+                qwtRectSearch( points, mid + 1, end, depth, rect, indexes );
+
+            end = mid;
+        }
+        else
+        {
+            begin = mid + 1;
+        }
+    }
+}
+
+//! Constructor, initializing an empty index
+QwtSpatialIndex::QwtSpatialIndex()
+{
+    d_data = new PrivateData;
+}
+
+//! Destructor
+QwtSpatialIndex::~QwtSpatialIndex()
+{
+    delete d_data;
+}
+
+/*!
+  \brief Build the index for a series
+
+  The complexity is O(n * log(n)). Points with NaN or infinite
+  coordinates are ignored.
+
+  \param series Series of points
+  \sa reset()
+ */
+void QwtSpatialIndex::build( const QwtSeriesData<QPointF> *series )
+{
+    reset();
+
+    d_data->isBuilt = true;
+
+    if ( series == NULL )
+        return;
+
+    const int numPoints = static_cast<int>( series->size() );
+
+    QVector<IndexedPoint> points( numPoints );
+    IndexedPoint *p = points.data();
+
+    int n = 0;
+    for ( int i = 0; i < numPoints; i++ )
+    {
+        const QPointF sample = series->sample( i );
+        // the tree can't be ordered by NaNs and the distances
+        // to infinite coordinates are undefined
+
+        if ( !qIsFinite( sample.x() ) || !qIsFinite( sample.y() ) )
+            continue;
+
+        p[n].x = sample.x();
+        p[n].y = sample.y();
+        p[n].index = i;
+
+        n++;
+    }
+
+    points.resize( n );
+
+    qwtBuildTree( points.data(), points.data() + n, 0 );
+
+    d_data->points = points;
+    d_data->isBuilt = true;
+}
+
+//! Remove all points from the index
+void QwtSpatialIndex::reset()
+{
+    d_data->points.clear();
+    d_data->points.squeeze();
+
+    d_data->isBuilt = false;
+}
+
+/*!
+  \return True, when the index has been built - even if no point
+          has been indexed, because the series had no valid points
+  \sa build(), reset(), isNull()
+ */
+bool QwtSpatialIndex::isBuilt() const
+{
+    return d_data->isBuilt;
+}
+
+//! \return True, when the index is empty
+bool QwtSpatialIndex::isNull() const
+{
+    return d_data->points.isEmpty();
+}
+
+//! \return Number of indexed points
+int QwtSpatialIndex::size() const
+{
+    return d_data->points.size();
+}
+
+/*!
+  Find the point, that is closest to a position
+
+  \param xMap Maps x-values into paint device coordinates.
+  \param yMap Maps y-values into paint device coordinates.
+  \param pos Position in paint device coordinates
+  \param dist If dist != NULL, closestPoint() returns the distance between
+              the position and the closest point
+
+  \return Index of the closest point in the series, or -1
+          when the index is empty
+ */
+int QwtSpatialIndex::closestPoint( const QwtScaleMap &xMap,
+    const QwtScaleMap &yMap, const QPointF &pos, double *dist ) const
+{
+    if ( d_data->points.isEmpty() )
+        return -1;
+
+    NearestSearch search( d_data->points.constData(), xMap, yMap, pos, 1 );
+    search.search( 0, d_data->points.size(), 0 );
+
+    if ( dist )
+        *dist = qSqrt( search.candidates.distance( 0 ) );
+
+    return search.candidates.index( 0 );
+}
+
+/*!
+  Find the points, that are closest to a position
+
+  \param xMap Maps x-values into paint device coordinates.
+  \param yMap Maps y-values into paint device coordinates.
+  \param pos Position in paint device coordinates
+  \param numPoints Maximum number of points
+
+  \return Indexes of the points in the series, sorted by their distance
+ */
+QVector<int> QwtSpatialIndex::closestPoints( const QwtScaleMap &xMap,
+    const QwtScaleMap &yMap, const QPointF &pos, int numPoints ) const
+{
+    QVector<int> indexes;
+
+    if ( d_data->points.isEmpty() || numPoints <= 0 )
+        return indexes;
+
+    // there are never more candidates than indexed points
+    numPoints = qMin( numPoints, d_data->points.size() );
+
+    NearestSearch search( d_data->points.constData(),
+        xMap, yMap, pos, numPoints );
+    search.search( 0, d_data->points.size(), 0 );
+
+    indexes.reserve( search.candidates.size() );
+    for ( int i = 0; i < search.candidates.size(); i++ )
+        indexes += search.candidates.index( i );
+
+    return indexes;
+}
+
+/*!
+  Find all points inside of a rectangle
+
+  \param xMap Maps x-values into paint device coordinates.
+  \param yMap Maps y-values into paint device coordinates.
+  \param rect Rectangle in paint device coordinates
+
+  \return Indexes of the points in the series, in no specific order
+ */
+QVector<int> QwtSpatialIndex::pointsInRect( const QwtScaleMap &xMap,
+    const QwtScaleMap &yMap, const QRectF &rect ) const
+{
+    QVector<int> indexes;
+
+    if ( d_data->points.isEmpty() )
+        return indexes;
+
+    const QRectF plotRect = QwtScaleMap::invTransform(
+        xMap, yMap, rect ).normalized();
+
+    qwtRectSearch( d_data->points.constData(),
+        0, d_data->points.size(), 0, plotRect, indexes );
+
+    return indexes;
+}
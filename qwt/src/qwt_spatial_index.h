@@ -0,0 +1,68 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_SPATIAL_INDEX_H
+#define QWT_SPATIAL_INDEX_H
+
+#include "qwt_global.h"
+#include "qwt_series_data.h"
+#include <qvector.h>
+
+class QwtScaleMap;
+class QPointF;
+class QRectF;
+
+/*!
+  \brief A k-d tree for searching the points of a series
+
+  QwtSpatialIndex organizes the points of a series in a 2-dimensional
+  tree, so that the closest points for a position or all points inside
+  of a rectangle can be found in logarithmic time.
+
+  The tree is built in plot coordinates, but the queries are done in
+  paint device coordinates, where the distances are evaluated. As the
+  transformations of QwtScaleMap are monotonic for each axis, the same
+  index can be used for any zoom level, canvas geometry or
+  scale transformation.
+
+  The index holds a copy of all points with finite coordinates.
+  It needs to be rebuilt, whenever the series has been modified.
+
+  \sa QwtPlotCurve::setSpatialIndexEnabled()
+*/
+class QWT_EXPORT QwtSpatialIndex
+{
+public:
+    QwtSpatialIndex();
+    ~QwtSpatialIndex();
+
+    void build( const QwtSeriesData<QPointF> * );
+    void reset();
+
+    bool isBuilt() const;
+    bool isNull() const;
+    int size() const;
+
+    int closestPoint( const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QPointF &pos, double *dist = NULL ) const;
+
+    QVector<int> closestPoints( const QwtScaleMap &xMap,
+        const QwtScaleMap &yMap, const QPointF &pos, int numPoints ) const;
+
+    QVector<int> pointsInRect( const QwtScaleMap &xMap,
+        const QwtScaleMap &yMap, const QRectF &rect ) const;
+
+private:
+    Q_DISABLE_COPY(QwtSpatialIndex)
+
+    class PrivateData;
+    PrivateData *d_data;
+};
+
+#endif
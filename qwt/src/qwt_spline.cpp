@@ -10,7 +10,9 @@
 #include "qwt_spline.h"
 #include "qwt_spline_parametrization.h"
 #include "qwt_bezier.h"
+#include "qwt_scale_map.h"
 #include "qwt_math.h"
+#include <limits>
 
 namespace QwtSplineC1P
 {
@@ -384,35 +386,85 @@ static inline SplineStore qwtSplineC1PathParametric(
     return store;
 }
 
+static inline void qwtPolynomialValues( const QwtSplinePolynomial &polynomial,
+    const QPointF &p1, QPointF *points, int numPoints )
+{
+    /*
+      The x coordinates of the points are the parameters of the
+      polynomial. As there are no dependencies between the iterations
+      the compiler is able to vectorize the loop.
+     */
+
+    const double x1 = p1.x();
+    const double y1 = p1.y();
+
+    const double c1 = polynomial.c1;
+    const double c2 = polynomial.c2;
+    const double c3 = polynomial.c3;
+
+    for ( int i = 0; i < numPoints; i++ )
+    {
+        const double t = points[i].x();
+
+        points[i].rx() = x1 + t;
+        points[i].ry() = y1 + ( ( ( c3 * t ) + c2 ) * t + c1 ) * t;
+    }
+}
+
 template< QwtSplinePolynomial toPolynomial( const QPointF &, double, const QPointF &, double ) >
 static QPolygonF qwtPolygonParametric( double distance,
     const QPolygonF &points, const QVector<double> values, bool withNodes ) 
 {
-    QPolygonF fittedPoints;
+    if ( distance <= 0.0 )
+        return QPolygonF();
 
     const QPointF *p = points.constData();
     const double *v = values.constData();
-    
+
+    const int n = points.size();
+
+    // an upper bound for the number of points, avoiding reallocations
+
+    double length = 0.0;
+    for ( int i = 0; i < n - 1; i++ )
+        length += qMax( p[i+1].x() - p[i].x(), 0.0 );
+
+    const double maxPoints = length / distance + 2.0 * n;
+
+    QPolygonF fittedPoints;
+    if ( maxPoints < std::numeric_limits<int>::max() )
+        fittedPoints.reserve( static_cast<int>( maxPoints ) );
+
     fittedPoints += p[0];
     double t = distance;
-    
-    const int n = points.size();
 
     for ( int i = 0; i < n - 1; i++ )
     {
         const QPointF &p1 = p[i];
         const QPointF &p2 = p[i+1];
 
-        const QwtSplinePolynomial polynomial = toPolynomial( p1, v[i], p2, v[i+1] );
-            
         const double l = p2.x() - p1.x();
-        
-        while ( t < l )
+
+        int numSteps = 0;
+        for ( double tx = t; tx < l; tx += distance )
+            numSteps++;
+
+        if ( numSteps > 0 )
         {
-            fittedPoints += QPointF( p1.x() + t, p1.y() + polynomial.valueAt( t ) );
-            t += distance;
-        }   
-        
+            const int from = fittedPoints.size();
+            fittedPoints.resize( from + numSteps );
+
+            QPointF *fp = fittedPoints.data() + from;
+            for ( int j = 0; j < numSteps; j++ )
+            {
+                fp[j].rx() = t;
+                t += distance;
+            }
+
+            const QwtSplinePolynomial polynomial = toPolynomial( p1, v[i], p2, v[i+1] );
+            qwtPolynomialValues( polynomial, p1, fp, numSteps );
+        }
+
         if ( withNodes )
         {
             if ( qFuzzyCompare( fittedPoints.last().x(), p2.x() ) )
@@ -489,7 +541,7 @@ public:
    
   \return polygon approximating the interpolating polynomials
 
-  \sa bezierControlLines(), QwtBezier
+  \sa bezierControlLines(), adaptivePolygon(), QwtBezier
  */
 QPolygonF QwtSpline::polygon( const QPolygonF &points, double tolerance ) const
 {
@@ -528,6 +580,128 @@ QPolygonF QwtSpline::polygon( const QPolygonF &points, double tolerance ) const
     return polygon;
 }
 
+/*!
+  \brief Interpolate a curve by a polygon in paint device coordinates
+
+  The points are mapped into paint device coordinates first - like
+  QwtPlotCurve does before passing them to a QwtSplineCurveFitter - and the
+  curves of the painterPath() are approximated with a tolerance in pixels.
+  So the number of points depends on the size of the curve on the
+  paint device and not on the number of control points:
+
+  - The subdivision of a Bezier curve stops, when its error
+    is below the tolerance.
+  - Bezier curves, that are outside of the clip rectangle, are
+    replaced by a line to their end point. As a Bezier curve is inside
+    the convex hull of its control points, they are not visible.
+  - Points closer than the tolerance to the previous point are
+    skipped - beside the last one.
+
+  \param xMap Maps x-values into paint device coordinates.
+  \param yMap Maps y-values into paint device coordinates.
+  \param points Control points in plot coordinates
+  \param clipRect Clip rectangle in paint device coordinates. For an invalid
+                  rectangle all curves are approximated.
+  \param tolerance Maximum for the accepted error of the approximation in pixels
+
+  \return Polygon in paint device coordinates approximating the spline
+
+  \sa polygon(), painterPath(), QwtBezier
+ */
+QPolygonF QwtSpline::adaptivePolygon(
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QPolygonF &points, const QRectF &clipRect, double tolerance ) const
+{
+    if ( tolerance <= 0.0 )
+        return QPolygonF();
+
+    const int numPoints = points.size();
+
+    QPolygonF mappedPoints( numPoints );
+    for ( int i = 0; i < numPoints; i++ )
+    {
+        mappedPoints[i].rx() = xMap.transform( points[i].x() );
+        mappedPoints[i].ry() = yMap.transform( points[i].y() );
+    }
+
+    const QPainterPath path = painterPath( mappedPoints );
+
+    const int n = path.elementCount();
+    if ( n == 0 )
+        return QPolygonF();
+
+    const bool doClip = clipRect.isValid();
+
+    QwtBezier bezier( tolerance );
+
+    QPolygonF polygon;
+    QPointF p1;
+
+    for ( int i = 0; i < n; i++ )
+    {
+        const QPainterPath::Element el = path.elementAt( i );
+
+        if ( el.type == QPainterPath::CurveToElement && i + 2 < n )
+        {
+            const QPointF cp1( el.x, el.y );
+            const QPointF cp2( path.elementAt( i + 1 ).x, path.elementAt( i + 1 ).y );
+            const QPointF p2( path.elementAt( i + 2 ).x, path.elementAt( i + 2 ).y );
+
+            i += 2;
+
+            bool isVisible = true;
+            if ( doClip )
+            {
+                // the curve is inside the bounding rectangle
+                // of its control points
+
+                const double x1 = qMin( qMin( p1.x(), p2.x() ), qMin( cp1.x(), cp2.x() ) );
+                const double x2 = qMax( qMax( p1.x(), p2.x() ), qMax( cp1.x(), cp2.x() ) );
+                const double y1 = qMin( qMin( p1.y(), p2.y() ), qMin( cp1.y(), cp2.y() ) );
+                const double y2 = qMax( qMax( p1.y(), p2.y() ), qMax( cp1.y(), cp2.y() ) );
+
+                isVisible = ( x2 >= clipRect.left() ) && ( x1 <= clipRect.right() )
+                    && ( y2 >= clipRect.top() ) && ( y1 <= clipRect.bottom() );
+            }
+
+            if ( isVisible )
+                bezier.appendToPolygon( p1, cp1, cp2, p2, polygon );
+            else
+                polygon += p2;
+
+            p1 = p2;
+        }
+        else
+        {
+            p1 = QPointF( el.x, el.y );
+
+            if ( polygon.isEmpty() || polygon.last() != p1 )
+                polygon += p1;
+        }
+    }
+
+    // skipping points, that are closer than the tolerance
+
+    const double tolerance2 = tolerance * tolerance;
+
+    QPointF *pd = polygon.data();
+    const int size = polygon.size();
+
+    int count = qMin( size, 1 );
+    for ( int i = 1; i < size; i++ )
+    {
+        const double dx = pd[i].x() - pd[count - 1].x();
+        const double dy = pd[i].y() - pd[count - 1].y();
+
+        if ( ( dx * dx + dy * dy >= tolerance2 ) || ( i == size - 1 ) )
+            pd[count++] = pd[i];
+    }
+
+    polygon.resize( count );
+
+    return polygon;
+}
+
 /*!
   \brief Constructor
 
@@ -938,6 +1112,256 @@ QPolygonF QwtSplineInterpolating::equidistantPolygon( const QPolygonF &points,
     return path;
 }
 
+static inline double qwtBezierParameter( double x,
+    double x1, double b1, double b2, double b3 )
+{
+    /*
+      x( t ) = x1 + b1 * t + b2 * t² + b3 * t³ is monotonic
+      for an interpolation of increasing x coordinates.
+      Newton iterations, falling back to bisection, when leaving
+      the bracket.
+     */
+
+    double lo = 0.0;
+    double hi = 1.0;
+    double t = ( x - x1 ) / ( b1 + b2 + b3 );
+
+    for ( int i = 0; i < 64; i++ )
+    {
+        const double dx = x1 + ( ( b3 * t + b2 ) * t + b1 ) * t - x;
+        if ( dx == 0.0 )
+            break;
+
+        if ( dx > 0.0 )
+            hi = t;
+        else
+            lo = t;
+
+        const double dxdt = ( 3.0 * b3 * t + 2.0 * b2 ) * t + b1;
+
+        double tNext = ( dxdt != 0.0 ) ? ( t - dx / dxdt ) : lo - 1.0;
+        if ( tNext <= lo || tNext >= hi )
+            tNext = 0.5 * ( lo + hi );
+
+        if ( tNext == t )
+            break;
+
+        t = tNext;
+    }
+
+    return t;
+}
+
+static inline void qwtInvalidateValues( double *values,
+    double *slopes, double *curvatures, int from, int to )
+{
+    const double nan = qQNaN();
+
+    for ( int i = from; i < to; i++ )
+    {
+        values[i] = nan;
+
+        if ( slopes )
+            slopes[i] = nan;
+
+        if ( curvatures )
+            curvatures[i] = nan;
+    }
+}
+
+/*!
+  \brief Evaluate the spline at a sorted array of x coordinates
+
+  The interpolation is calculated once by bezierControlLines() and the
+  polynomials for the x coordinates are found by walking through the
+  control points and the x coordinates in parallel. The values of
+  all coordinates in the same interval are calculated in one loop.
+
+  Values outside of the interval of the control points are NaN.
+  Intervals of zero length are skipped, so that an x coordinate
+  of duplicated control points is evaluated in the interval before.
+
+  \param points Control points, with increasing x coordinates
+  \param xValues x coordinates in increasing order
+  \param slopes If slopes != NULL, the values of the first derivative
+                at the x coordinates are returned in slopes
+  \param curvatures If curvatures != NULL, the values of the second
+                derivative at the x coordinates are returned in curvatures
+
+  \return Values of the spline at the x coordinates. An empty vector
+          is returned for parametric splines
+          ( see QwtSplineParametrization::ParameterX )
+
+  \sa QwtSplineC1::polynomials(), QwtSplineC2::polynomials()
+ */
+QVector<double> QwtSplineInterpolating::valuesAt( const QPolygonF &points,
+    const QVector<double> &xValues, QVector<double> *slopes,
+    QVector<double> *curvatures ) const
+{
+    if ( parametrization()->type() != QwtSplineParametrization::ParameterX
+        || boundaryType() == QwtSpline::ClosedPolygon )
+    {
+        return QVector<double>();
+    }
+
+    const int n = points.size();
+    if ( n <= 1 )
+        return QVector<double>();
+
+    const QVector<QLineF> controlLines = bezierControlLines( points );
+    if ( controlLines.size() < n - 1 )
+        return QVector<double>();
+
+    const int numValues = xValues.size();
+
+    QVector<double> values( numValues );
+
+    double *yv = values.data();
+    double *sv = NULL;
+    double *cv = NULL;
+
+    if ( slopes )
+    {
+        slopes->resize( numValues );
+        sv = slopes->data();
+    }
+
+    if ( curvatures )
+    {
+        curvatures->resize( numValues );
+        cv = curvatures->data();
+    }
+
+    const QPointF *p = points.constData();
+    const QLineF *cl = controlLines.constData();
+    const double *xv = xValues.constData();
+
+    int j = 0;
+    while ( j < numValues && xv[j] < p[0].x() )
+        j++;
+
+    const int from = j;
+
+    // the last interval, that is not of zero length, includes its end point
+
+    int last = n - 2;
+    while ( last > 0 && p[last + 1].x() <= p[last].x() )
+        last--;
+
+    for ( int i = 0; i < n - 1 && j < numValues; i++ )
+    {
+        const double x1 = p[i].x();
+        const double y1 = p[i].y();
+        const double x2 = p[i + 1].x();
+        const double y2 = p[i + 1].y();
+
+        const double h = x2 - x1;
+        if ( h <= 0.0 )
+            continue;
+
+        int k = j;
+        if ( i < last )
+        {
+            while ( k < numValues && xv[k] < x2 )
+                k++;
+        }
+        else
+        {
+            while ( k < numValues && xv[k] <= x2 )
+                k++;
+        }
+
+        if ( k == j )
+            continue;
+
+        const double cx1 = cl[i].x1();
+        const double cy1 = cl[i].y1();
+        const double cx2 = cl[i].x2();
+        const double cy2 = cl[i].y2();
+
+        // power basis of the Bezier curve: x1 + b1 * t + b2 * t² + b3 * t³
+
+        const double a1 = 3.0 * ( cy1 - y1 );
+        const double a2 = 3.0 * ( y1 - 2.0 * cy1 + cy2 );
+        const double a3 = y2 - y1 + 3.0 * ( cy1 - cy2 );
+
+        const double b1 = 3.0 * ( cx1 - x1 );
+        const double b2 = 3.0 * ( x1 - 2.0 * cx1 + cx2 );
+        const double b3 = x2 - x1 + 3.0 * ( cx1 - cx2 );
+
+        if ( qAbs( b2 ) + qAbs( b3 ) <= 1e-10 * qAbs( h ) )
+        {
+            /*
+              The control points are at 1/3 and 2/3 of the interval,
+              like for all C1/C2 splines: y is a polynomial of x.
+              No dependencies between the iterations, so that
+              the loops can be vectorized by the compiler.
+             */
+            const double c1 = a1 / h;
+            const double c2 = a2 / ( h * h );
+            const double c3 = a3 / ( h * h * h );
+
+            for ( int m = j; m < k; m++ )
+            {
+                const double dx = xv[m] - x1;
+                yv[m] = y1 + ( ( c3 * dx + c2 ) * dx + c1 ) * dx;
+            }
+
+            if ( sv )
+            {
+                for ( int m = j; m < k; m++ )
+                {
+                    const double dx = xv[m] - x1;
+                    sv[m] = ( 3.0 * c3 * dx + 2.0 * c2 ) * dx + c1;
+                }
+            }
+
+            if ( cv )
+            {
+                for ( int m = j; m < k; m++ )
+                    cv[m] = 6.0 * c3 * ( xv[m] - x1 ) + 2.0 * c2;
+            }
+        }
+        else
+        {
+            // the parameter of the Bezier curve needs to be found first
+
+            for ( int m = j; m < k; m++ )
+            {
+                const double t = qwtBezierParameter( xv[m], x1, b1, b2, b3 );
+
+                yv[m] = y1 + ( ( a3 * t + a2 ) * t + a1 ) * t;
+
+                if ( sv || cv )
+                {
+                    const double dx = ( 3.0 * b3 * t + 2.0 * b2 ) * t + b1;
+                    const double dy = ( 3.0 * a3 * t + 2.0 * a2 ) * t + a1;
+
+                    if ( sv )
+                        sv[m] = dy / dx;
+
+                    if ( cv )
+                    {
+                        const double ddx = 6.0 * b3 * t + 2.0 * b2;
+                        const double ddy = 6.0 * a3 * t + 2.0 * a2;
+
+                        cv[m] = ( ddy * dx - dy * ddx ) / ( dx * dx * dx );
+                    }
+                }
+            }
+        }
+
+        j = k;
+    }
+
+    // outside of the control points
+
+    qwtInvalidateValues( yv, sv, cv, 0, from );
+    qwtInvalidateValues( yv, sv, cv, j, numValues );
+
+    return values;
+}
+
 //! Constructor
 QwtSplineG1::QwtSplineG1()
 {
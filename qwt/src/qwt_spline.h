@@ -18,6 +18,8 @@
 #include <qmath.h>
 
 class QwtSplineParametrization;
+class QwtScaleMap;
+class QRectF;
 
 /*!
   \brief Base class for all splines 
@@ -171,6 +173,9 @@ public:
     virtual QPolygonF polygon( const QPolygonF &, double tolerance ) const;
     virtual QPainterPath painterPath( const QPolygonF & ) const = 0;
 
+    QPolygonF adaptivePolygon( const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QPolygonF &, const QRectF &clipRect, double tolerance = 0.5 ) const;
+
     virtual uint locality() const;
 
 private:
@@ -200,6 +205,10 @@ public:
     virtual QPainterPath painterPath( const QPolygonF & ) const;
     virtual QVector<QLineF> bezierControlLines( const QPolygonF &points ) const = 0;
 
+    QVector<double> valuesAt( const QPolygonF &,
+        const QVector<double> &xValues, QVector<double> *slopes = NULL,
+        QVector<double> *curvatures = NULL ) const;
+
 private:
     Q_DISABLE_COPY(QwtSplineInterpolating)
 };
@@ -515,44 +515,64 @@ namespace QwtSplineCubicP
     private:
         Equation2 substituteSpline( const QPolygonF &points, const Equation2 &eq )
         {
+            /*
+              Backward elimination of the Thomas algorithm. For each
+              equation only the diagonal and the right hand side are
+              stored as pairs in one buffer: the lower diagonal is the
+              distance between the points and is recalculated in
+              resolveSpline().
+
+              eq[i].resolved2( b[i-1] ) => b[i]
+             */
+
             const int n = points.size();
+            const QPointF *p = points.constData();
+
+            d_workspace.resize( 2 * ( n - 2 ) );
+            double *w = d_workspace.data();
 
-            d_eq.resize( n - 2 );
-            d_eq[n-3] = eq;
+            double h2 = eq.p;
+            double q2 = eq.q;
+            double r2 = eq.r;
 
-            // eq[i].resolved2( b[i-1] ) => b[i]
+            w[2 * ( n - 3 )] = q2;
+            w[2 * ( n - 3 ) + 1] = r2;
 
-            double slope2 = ( points[n-3].y() - points[n-4].y() ) / eq.p;
+            double slope2 = ( p[n-3].y() - p[n-4].y() ) / h2;
 
             for ( int i = n - 4; i > 1; i-- )
             {
-                const Equation2 &eq2 = d_eq[i+1];
-                Equation2 &eq1 = d_eq[i];
+                const double h1 = p[i].x() - p[i-1].x();
+                const double slope1 = ( p[i].y() - p[i-1].y() ) / h1;
 
-                eq1.p = points[i].x() - points[i-1].x();
-                const double slope1 = ( points[i].y() - points[i-1].y() ) / eq1.p;
+                const double v = h2 / q2;
 
-                const double v = eq2.p / eq2.q;
+                q2 = 2.0 * ( h1 + h2 ) - v * h2;
+                r2 = 3.0 * ( slope2 - slope1 ) - v * r2;
 
-                eq1.q = 2.0 * ( eq1.p + eq2.p ) - v * eq2.p;
-                eq1.r = 3.0 * ( slope2 - slope1 ) - v * eq2.r;
+                w[2 * i] = q2;
+                w[2 * i + 1] = r2;
 
+                h2 = h1;
                 slope2 = slope1;
             }
 
-            return d_eq[2];
+            return Equation2( h2, q2, r2 );
         }
 
         double resolveSpline( const QPolygonF &points, double b1 )
         {
             const int n = points.size();
             const QPointF *p = points.constData();
+            const double *w = d_workspace.constData();
 
             for ( int i = 2; i < n - 2; i++ )
             {
+                const double h = p[i].x() - p[i-1].x();
+
                 // eq[i].resolved2( b[i-1] ) => b[i]
-                const double b2 = d_eq[i].resolved2( b1 );
-                d_store.storeNext( i, d_eq[i].p, p[i-1], p[i], b1, b2 );
+                const double b2 = ( w[2 * i + 1] - h * b1 ) / w[2 * i];
+                d_store.storeNext( i, h, p[i-1], p[i], b1, b2 );
 
                 b1 = b2;
             }
@@ -562,7 +582,7 @@ namespace QwtSplineCubicP
 
     private:
         Equation3 d_conditionsEQ[2];
-        QVector<Equation2> d_eq;
+        QVector<double> d_workspace;
         T d_store;
     };
 
@@ -0,0 +1,276 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_spline_local_incremental.h"
+#include "qwt_spline_parametrization.h"
+#include <qpainterpath.h>
+
+static inline bool qwtIsIncremental( const QwtSplineLocal *spline )
+{
+    return ( spline->parametrization()->type() == QwtSplineParametrization::ParameterX )
+        && ( spline->boundaryType() == QwtSpline::ConditionalBoundaries );
+}
+
+class QwtSplineLocalIncremental::PrivateData
+{
+public:
+    PrivateData():
+        spline( NULL )
+    {
+    }
+
+    ~PrivateData()
+    {
+        delete spline;
+    }
+
+    QwtSplineLocal *spline;
+
+    QPolygonF points;
+    QVector<double> slopes;
+    QVector<QLineF> controlLines;
+};
+
+/*!
+  \brief Constructor
+
+  \param type Type of the spline interpolation
+  \sa setSpline()
+ */
+QwtSplineLocalIncremental::QwtSplineLocalIncremental( QwtSplineLocal::Type type )
+{
+    d_data = new PrivateData;
+    d_data->spline = new QwtSplineLocal( type );
+}
+
+//! Destructor
+QwtSplineLocalIncremental::~QwtSplineLocalIncremental()
+{
+    delete d_data;
+}
+
+/*!
+  \brief Assign a spline
+
+  The slopes and control lines are recalculated for all points.
+
+  \param spline Spline
+  \sa spline()
+
+  \note The spline will be deleted, when another spline is assigned or
+        in the destructor. A spline, that is NULL, is ignored.
+ */
+void QwtSplineLocalIncremental::setSpline( QwtSplineLocal *spline )
+{
+    if ( spline == NULL || spline == d_data->spline )
+        return;
+
+    delete d_data->spline;
+    d_data->spline = spline;
+
+    recalculate( 0 );
+}
+
+/*!
+  \return Spline
+  \sa setSpline()
+ */
+const QwtSplineLocal *QwtSplineLocalIncremental::spline() const
+{
+    return d_data->spline;
+}
+
+/*!
+  \brief Replace all points
+
+  The slopes and control lines are recalculated for all points.
+
+  \param points Control points
+  \sa appendPoints(), points()
+ */
+void QwtSplineLocalIncremental::setPoints( const QPolygonF &points )
+{
+    d_data->points = points;
+    recalculate( 0 );
+}
+
+/*!
+  \brief Append points
+
+  Only the slopes and control lines, that are affected by
+  the new points, are recalculated.
+
+  \param points Points to be appended
+  \sa setPoints(), reset()
+ */
+void QwtSplineLocalIncremental::appendPoints( const QPolygonF &points )
+{
+    if ( points.isEmpty() )
+        return;
+
+    const int from = d_data->points.size();
+
+    d_data->points += points;
+    recalculate( from );
+}
+
+//! Remove all points
+void QwtSplineLocalIncremental::reset()
+{
+    d_data->points.clear();
+    d_data->slopes.clear();
+    d_data->controlLines.clear();
+}
+
+/*!
+  \return Control points
+  \sa setPoints(), appendPoints()
+ */
+QPolygonF QwtSplineLocalIncremental::points() const
+{
+    return d_data->points;
+}
+
+/*!
+  \return Values of the first derivative at the control points
+          as calculated by QwtSplineLocal::slopes()
+ */
+QVector<double> QwtSplineLocalIncremental::slopes() const
+{
+    return d_data->slopes;
+}
+
+/*!
+  \return Control points of the interpolating Bezier curves
+          as calculated by QwtSplineLocal::bezierControlLines()
+ */
+QVector<QLineF> QwtSplineLocalIncremental::bezierControlLines() const
+{
+    return d_data->controlLines;
+}
+
+/*!
+  \brief Interpolation as painter path
+
+  The path is built from the cached control lines, but
+  needs to be created for all points.
+
+  \return Painter path, that can be rendered by QPainter
+ */
+QPainterPath QwtSplineLocalIncremental::painterPath() const
+{
+    QPainterPath path;
+
+    const QPolygonF &points = d_data->points;
+    const QVector<QLineF> &lines = d_data->controlLines;
+
+    const int n = points.size();
+    if ( n == 0 || lines.size() < n - 1 )
+        return path;
+
+    const QPointF *p = points.constData();
+    const QLineF *l = lines.constData();
+
+    path.moveTo( p[0] );
+    for ( int i = 0; i < lines.size(); i++ )
+    {
+        // closed polygons have an additional line back to the first point
+        const QPointF &p2 = ( i < n - 1 ) ? p[i+1] : p[0];
+        path.cubicTo( l[i].p1(), l[i].p2(), p2 );
+    }
+
+    if ( d_data->spline->boundaryType() == QwtSpline::ClosedPolygon )
+        path.closeSubpath();
+
+    return path;
+}
+
+/*!
+  Recalculate the slopes and control lines
+
+  \param from Index of the first point, that has been appended.
+ */
+void QwtSplineLocalIncremental::recalculate( int from )
+{
+    const QwtSplineLocal *spline = d_data->spline;
+    const QPolygonF &points = d_data->points;
+
+    const int n = points.size();
+    if ( n <= 1 )
+    {
+        d_data->slopes.clear();
+        d_data->controlLines.clear();
+
+        return;
+    }
+
+    if ( !qwtIsIncremental( spline ) || d_data->slopes.size() != from )
+    {
+        // nothing valid to continue with
+        from = 0;
+    }
+
+    /*
+      The slopes at the points before the previous last point
+      depend on a few neighbours only. In a subpolygon, that starts
+      'locality' points before the first slope to be recalculated,
+      all slopes behind 'locality' points are the same as those
+      for the complete polygon.
+     */
+
+    const int locality = qMax( int( spline->locality() ), 1 );
+
+    int first = qMax( from - 1 - locality, 0 );
+    int start = qMax( first - locality, 0 );
+
+    if ( start == 0 )
+        first = 0;
+
+    if ( first == 0 )
+    {
+        d_data->slopes = spline->slopes( points );
+        d_data->controlLines = spline->bezierControlLines( points );
+
+        return;
+    }
+
+    const QPolygonF subPolygon = points.mid( start );
+
+    const QVector<double> subSlopes = spline->slopes( subPolygon );
+    if ( subSlopes.size() != subPolygon.size() )
+    {
+        d_data->slopes.clear();
+        d_data->controlLines.clear();
+
+        return;
+    }
+
+    QVector<double> &slopes = d_data->slopes;
+    slopes.resize( n );
+
+    double *m = slopes.data();
+    for ( int i = first; i < n; i++ )
+        m[i] = subSlopes[i - start];
+
+    // the control lines between the recalculated slopes
+
+    QVector<QLineF> &lines = d_data->controlLines;
+    lines.resize( n - 1 );
+
+    const QPointF *p = points.constData();
+    QLineF *l = lines.data();
+
+    for ( int i = first - 1; i < n - 1; i++ )
+    {
+        const double dx3 = ( p[i+1].x() - p[i].x() ) / 3.0;
+
+        l[i].setLine( p[i].x() + dx3, p[i].y() + m[i] * dx3,
+            p[i+1].x() - dx3, p[i+1].y() - m[i+1] * dx3 );
+    }
+}
@@ -0,0 +1,80 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_SPLINE_LOCAL_INCREMENTAL_H
+#define QWT_SPLINE_LOCAL_INCREMENTAL_H
+
+#include "qwt_global.h"
+#include "qwt_spline_local.h"
+#include <qpolygon.h>
+#include <qline.h>
+#include <qvector.h>
+
+class QPainterPath;
+
+/*!
+  \brief Interpolation of a growing polygon by a QwtSplineLocal
+
+  The slopes of a QwtSplineLocal depend on a few neighbouring points only
+  ( see QwtSpline::locality() ). QwtSplineLocalIncremental keeps the points,
+  the slopes and the Bezier control lines of the interpolation. When points
+  are appended only the slopes and control lines at the end of the polygon,
+  that are affected by the new points, are recalculated. The cost for
+  appending k points is O(k) instead of O(n).
+
+  \code
+    QwtSplineLocalIncremental spline( QwtSplineLocal::Akima );
+
+    void Acquisition::append( const QPolygonF &points )
+    {
+        spline.appendPoints( points );
+        update( spline.painterPath() );
+    }
+  \endcode
+
+  The results are the same as those of QwtSplineLocal::slopes() and
+  QwtSplineLocal::bezierControlLines() for all points.
+
+  \note The incremental calculation is only possible for the non parametric
+        interpolation ( QwtSplineParametrization::ParameterX ) and
+        when the boundary type is QwtSpline::ConditionalBoundaries.
+        Otherwise all slopes and control lines are recalculated.
+ */
+class QWT_EXPORT QwtSplineLocalIncremental
+{
+public:
+    explicit QwtSplineLocalIncremental(
+        QwtSplineLocal::Type = QwtSplineLocal::Cardinal );
+
+    ~QwtSplineLocalIncremental();
+
+    void setSpline( QwtSplineLocal * );
+    const QwtSplineLocal *spline() const;
+
+    void setPoints( const QPolygonF & );
+    void appendPoints( const QPolygonF & );
+    void reset();
+
+    QPolygonF points() const;
+
+    QVector<double> slopes() const;
+    QVector<QLineF> bezierControlLines() const;
+
+    QPainterPath painterPath() const;
+
+private:
+    Q_DISABLE_COPY(QwtSplineLocalIncremental)
+
+    void recalculate( int from );
+
+    class PrivateData;
+    PrivateData *d_data;
+};
+
+#endif
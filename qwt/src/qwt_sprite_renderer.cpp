@@ -0,0 +1,377 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_sprite_renderer.h"
+#include "qwt_painter.h"
+#include <qpainter.h>
+#include <qpaintengine.h>
+#include <qvector.h>
+#include <qthread.h>
+#include <qfuture.h>
+#include <qtconcurrentrun.h>
+#include <limits>
+
+namespace
+{
+    class Sprite
+    {
+    public:
+        QImage image;
+
+        // position of the image relative to a point
+        QPoint offset;
+    };
+
+    class SpriteBits
+    {
+    public:
+        const uchar *bits;
+        int bytesPerLine;
+        int width;
+        int height;
+
+        // position relative to a point in layer coordinates
+        int dx;
+        int dy;
+    };
+}
+
+// Helper class to work around the 5 parameters
+// limitation of QtConcurrent::run()
+class QwtStampCommand
+{
+public:
+    const QPointF *points;
+    const int *spriteIds;
+    int numPoints;
+
+    const SpriteBits *sprites;
+
+    uchar *layerBits;
+    int layerBytesPerLine;
+    int layerWidth;
+};
+
+static void qwtStampRows( const QwtStampCommand &command, int y0, int y1 )
+{
+    // blending all sprites into the rows [y0, y1[ of the layer,
+    // keeping the order of the points
+
+    for ( int i = 0; i < command.numPoints; i++ )
+    {
+        const SpriteBits &sprite = command.spriteIds
+            ? command.sprites[ command.spriteIds[i] ] : command.sprites[0];
+
+        const int left = qRound( command.points[i].x() ) + sprite.dx;
+        const int top = qRound( command.points[i].y() ) + sprite.dy;
+
+        const int r0 = qMax( top, y0 );
+        const int r1 = qMin( top + sprite.height, y1 );
+        if ( r0 >= r1 )
+            continue;
+
+        const int c0 = qMax( left, 0 );
+        const int c1 = qMin( left + sprite.width, command.layerWidth );
+        if ( c0 >= c1 )
+            continue;
+
+        for ( int y = r0; y < r1; y++ )
+        {
+            const QRgb *src = reinterpret_cast<const QRgb *>(
+                sprite.bits + ( y - top ) * sprite.bytesPerLine ) + ( c0 - left );
+
+            QRgb *dst = reinterpret_cast<QRgb *>(
+                command.layerBits + y * command.layerBytesPerLine ) + c0;
+
+            for ( int x = c0; x < c1; x++ )
+            {
+                *dst = QwtSpriteRenderer::blendPixel( *src, *dst );
+
+                src++;
+                dst++;
+            }
+        }
+    }
+}
+
+class QwtSpriteRenderer::PrivateData
+{
+public:
+    QVector<Sprite> sprites;
+};
+
+//! Constructor
+QwtSpriteRenderer::QwtSpriteRenderer()
+{
+    d_data = new PrivateData;
+}
+
+//! Destructor
+QwtSpriteRenderer::~QwtSpriteRenderer()
+{
+    delete d_data;
+}
+
+/*!
+  Add a sprite
+
+  \param image Image of the sprite. It will be converted
+               to QImage::Format_ARGB32_Premultiplied.
+  \param offset Position of the top left corner of the image
+                relative to a point
+
+  \return Id of the sprite, that can be used in render()
+  \sa render(), clear()
+ */
+int QwtSpriteRenderer::addSprite( const QImage &image, const QPoint &offset )
+{
+    Sprite sprite;
+    sprite.offset = offset;
+
+    if ( image.format() == QImage::Format_ARGB32_Premultiplied )
+        sprite.image = image;
+    else
+        sprite.image = image.convertToFormat( QImage::Format_ARGB32_Premultiplied );
+
+    d_data->sprites += sprite;
+    return d_data->sprites.size() - 1;
+}
+
+/*!
+  \return Image of a sprite
+  \param id Id of the sprite, returned from addSprite()
+ */
+QImage QwtSpriteRenderer::sprite( int id ) const
+{
+    if ( id < 0 || id >= d_data->sprites.size() )
+        return QImage();
+
+    return d_data->sprites[id].image;
+}
+
+/*!
+  \return Position of the top left corner of a sprite
+          relative to a point
+  \param id Id of the sprite, returned from addSprite()
+ */
+QPoint QwtSpriteRenderer::offset( int id ) const
+{
+    if ( id < 0 || id >= d_data->sprites.size() )
+        return QPoint();
+
+    return d_data->sprites[id].offset;
+}
+
+//! \return Number of sprites
+int QwtSpriteRenderer::spriteCount() const
+{
+    return d_data->sprites.size();
+}
+
+//! Remove all sprites
+void QwtSpriteRenderer::clear()
+{
+    d_data->sprites.clear();
+}
+
+/*!
+  \brief Check if sprites can be stamped for a painter
+
+  Stamping needs a paint engine, that is rasterizing, a painter
+  transformation, that is not more than a translation, and source over
+  composition. For vector devices like PDF or SVG documents
+  it is not supported.
+
+  As the sprites are blended in device independent pixels, devices
+  with a device pixel ratio != 1 ( f.e. high DPI screens ) are
+  not supported either.
+
+  \param painter Painter
+  \return True, when render() can be used for the painter
+ */
+bool QwtSpriteRenderer::isSupported( const QPainter *painter )
+{
+    if ( painter == NULL || !painter->isActive() )
+        return false;
+
+    if ( painter->transform().type() > QTransform::TxTranslate )
+        return false;
+
+    if ( painter->compositionMode() != QPainter::CompositionMode_SourceOver )
+        return false;
+
+    if ( QwtPainter::devicePixelRatio( painter->device() ) != 1.0 )
+        return false;
+
+    switch( painter->paintEngine()->type() )
+    {
+        case QPaintEngine::Raster:
+        case QPaintEngine::X11:
+        case QPaintEngine::Windows:
+        case QPaintEngine::CoreGraphics:
+        case QPaintEngine::OpenGL:
+        case QPaintEngine::OpenGL2:
+            return true;
+        default:
+            break;
+    }
+
+    return false;
+}
+
+/*!
+  \brief Stamp sprites at a set of positions
+
+  The sprites are blended into a layer, that is painted with one
+  call of QPainter::drawImage(). Positions are rounded to integers.
+  The layer is clipped to the paint device and the clip region
+  of the painter.
+
+  When only a few sprites are spread over a large area,
+  composing a layer is more expensive than painting each sprite.
+  In this case nothing is painted and false is returned.
+
+  \param painter Painter
+  \param points Positions in paint device coordinates
+  \param spriteIds Ids of the sprites for each position. If spriteIds
+                   is NULL all positions are painted with the first sprite.
+  \param numPoints Number of positions
+
+  \return True, when the sprites have been painted
+  \sa isSupported()
+ */
+bool QwtSpriteRenderer::render( QPainter *painter, const QPointF *points,
+    const int *spriteIds, int numPoints ) const
+{
+    if ( numPoints <= 0 || d_data->sprites.isEmpty() )
+        return true;
+
+    if ( !isSupported( painter ) )
+        return false;
+
+    const int numSprites = d_data->sprites.size();
+
+    QVector<SpriteBits> sprites( numSprites );
+    for ( int i = 0; i < numSprites; i++ )
+    {
+        const Sprite &s = d_data->sprites[i];
+
+        sprites[i].bits = s.image.constBits();
+        sprites[i].bytesPerLine = s.image.bytesPerLine();
+        sprites[i].width = s.image.width();
+        sprites[i].height = s.image.height();
+        sprites[i].dx = s.offset.x();
+        sprites[i].dy = s.offset.y();
+    }
+
+    // the bounding rectangle of all sprites
+
+    int x1 = std::numeric_limits<int>::max();
+    int y1 = std::numeric_limits<int>::max();
+    int x2 = std::numeric_limits<int>::min();
+    int y2 = std::numeric_limits<int>::min();
+
+    qint64 stampArea = 0;
+
+    for ( int i = 0; i < numPoints; i++ )
+    {
+        const SpriteBits &sprite =
+            spriteIds ? sprites[ spriteIds[i] ] : sprites[0];
+
+        const int left = qRound( points[i].x() ) + sprite.dx;
+        const int top = qRound( points[i].y() ) + sprite.dy;
+
+        x1 = qMin( x1, left );
+        y1 = qMin( y1, top );
+        x2 = qMax( x2, left + sprite.width );
+        y2 = qMax( y2, top + sprite.height );
+
+        stampArea += sprite.width * sprite.height;
+    }
+
+    QRect layerRect( x1, y1, x2 - x1, y2 - y1 );
+
+    // no need to have pixels outside of the device or clip region
+
+    const QPaintDevice *device = painter->device();
+    const QRect deviceRect = painter->transform().inverted().mapRect(
+        QRect( 0, 0, device->width(), device->height() ) );
+
+    layerRect &= deviceRect;
+
+    if ( painter->hasClipping() )
+        layerRect &= painter->clipBoundingRect().toAlignedRect();
+
+    if ( layerRect.isEmpty() )
+        return true;
+
+    const qint64 layerArea = qint64( layerRect.width() ) * layerRect.height();
+    if ( layerArea > 16 * stampArea )
+    {
+        // a few sparse sprites on a large area, where painting
+        // each sprite is faster than composing a layer
+        return false;
+    }
+
+    QImage layer( layerRect.size(), QImage::Format_ARGB32_Premultiplied );
+    if ( layer.isNull() )
+        return false;
+
+    layer.fill( 0 );
+
+    for ( int i = 0; i < numSprites; i++ )
+    {
+        sprites[i].dx -= layerRect.left();
+        sprites[i].dy -= layerRect.top();
+    }
+
+    QwtStampCommand command;
+    command.points = points;
+    command.spriteIds = spriteIds;
+    command.numPoints = numPoints;
+    command.sprites = sprites.constData();
+    command.layerBits = layer.bits();
+    command.layerBytesPerLine = layer.bytesPerLine();
+    command.layerWidth = layer.width();
+
+    int numThreads = 1;
+
+#if !defined(QT_NO_QFUTURE)
+    if ( stampArea > 100000 )
+    {
+        numThreads = QThread::idealThreadCount();
+        if ( numThreads <= 0 )
+            numThreads = 1;
+
+        numThreads = qMin( numThreads, layerRect.height() );
+    }
+#endif
+
+    const int numRows = layerRect.height() / numThreads;
+
+#if !defined(QT_NO_QFUTURE)
+    QList< QFuture<void> > futures;
+    for ( int i = 0; i < numThreads - 1; i++ )
+    {
+        futures += QtConcurrent::run( &qwtStampRows,
+            command, i * numRows, ( i + 1 ) * numRows );
+    }
+#endif
+
+    qwtStampRows( command, ( numThreads - 1 ) * numRows, layerRect.height() );
+
+#if !defined(QT_NO_QFUTURE)
+    for ( int i = 0; i < futures.size(); i++ )
+        futures[i].waitForFinished();
+#endif
+
+    painter->drawImage( layerRect.topLeft(), layer );
+
+    return true;
+}
@@ -0,0 +1,96 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_SPRITE_RENDERER_H
+#define QWT_SPRITE_RENDERER_H
+
+#include "qwt_global.h"
+#include <qimage.h>
+#include <qpoint.h>
+
+class QPainter;
+class QPointF;
+
+/*!
+  \brief Blends pre-rendered images at many positions into one image
+
+  Painting the same small image thousands of times is dominated by
+  the overhead of the paint engine for each call. QwtSpriteRenderer
+  blends a set of sprites into an ARGB32 layer, that covers all positions,
+  and paints this layer with one QPainter::drawImage() call. The rows of
+  the layer are filled by concurrent threads.
+
+  Each position can be painted with a different sprite, what is
+  useful for symbols with individual colors or sizes. The sprites are
+  blended in the order of the positions, so that overlapping sprites
+  look the same as when painting them one by one.
+
+  \note Stamping is only supported for painters on raster devices
+        without scaling, a device pixel ratio of 1 and source over
+        composition - see isSupported().
+
+  \sa QwtSymbol::drawSymbols(), QwtPlotSpectroCurve::drawSymbols()
+*/
+class QWT_EXPORT QwtSpriteRenderer
+{
+public:
+    QwtSpriteRenderer();
+    ~QwtSpriteRenderer();
+
+    int addSprite( const QImage &, const QPoint &offset );
+
+    QImage sprite( int id ) const;
+    QPoint offset( int id ) const;
+
+    int spriteCount() const;
+    void clear();
+
+    static bool isSupported( const QPainter * );
+
+    bool render( QPainter *, const QPointF *points,
+        const int *spriteIds, int numPoints ) const;
+
+    static QRgb blendPixel( QRgb src, QRgb dst );
+
+private:
+    Q_DISABLE_COPY(QwtSpriteRenderer)
+
+    class PrivateData;
+    PrivateData *d_data;
+};
+
+/*!
+  \brief Blend a pixel with source over composition
+
+  \param src Premultiplied color of the source
+  \param dst Premultiplied color of the destination
+
+  \return Premultiplied color of the blended pixel
+ */
+inline QRgb QwtSpriteRenderer::blendPixel( QRgb src, QRgb dst )
+{
+    const uint alpha = qAlpha( src );
+    if ( alpha == 255 )
+        return src;
+
+    if ( alpha == 0 )
+        return dst;
+
+    const uint ia = 255 - alpha;
+
+    uint rb = ( dst & 0xff00ff ) * ia;
+    rb = ( ( rb + ( ( rb >> 8 ) & 0xff00ff ) + 0x800080 ) >> 8 ) & 0xff00ff;
+
+    uint ag = ( ( dst >> 8 ) & 0xff00ff ) * ia;
+    ag = ( ag + ( ( ag >> 8 ) & 0xff00ff ) + 0x800080 ) & 0xff00ff00;
+
+    return src + ( rb | ag );
+}
+
+#endif
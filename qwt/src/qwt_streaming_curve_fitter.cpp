@@ -0,0 +1,498 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_streaming_curve_fitter.h"
+#include "qwt_math.h"
+#include <qpainterpath.h>
+#include <qvector.h>
+#include <qthread.h>
+#include <qfuture.h>
+#include <qtconcurrentrun.h>
+
+// polygons with less points are not split, when the chunk size is 0
+static const int qwtMinChunkSize = 100000;
+
+// maximum for the points since the anchor, that might be revisited
+static const int qwtMaxPending = 1024;
+
+namespace
+{
+    /*
+      The directions from the anchor, that keep all points since
+      the anchor inside of the tolerance, are a cone. Each point
+      narrows the cone down, until the direction of a point is outside:
+      then the last point, that has been inside, becomes the next anchor.
+
+      The points behind the new anchor have to be processed again.
+      To limit this work an anchor is forced, when more than
+      qwtMaxPending points have been collected since the last anchor.
+     */
+    class Simplifier
+    {
+    public:
+        explicit Simplifier( double tolerance ):
+            d_tolerance( tolerance ),
+            d_tolerance2( tolerance * tolerance ),
+            d_hasAnchor( false ),
+            d_first( 0 )
+        {
+            resetCone();
+        }
+
+        inline void append( const QPointF &point, QPolygonF &out )
+        {
+            if ( qIsNaN( point.x() ) || qIsNaN( point.y() ) )
+                return;
+
+            if ( !d_hasAnchor )
+            {
+                d_anchor = point;
+                d_hasAnchor = true;
+
+                out += point;
+                return;
+            }
+
+            d_pending += point;
+            process( numPending() - 1, out );
+
+            if ( numPending() > qwtMaxPending )
+            {
+                // the candidate is a valid anchor for all points before
+                nextAnchor( out );
+                process( 0, out );
+            }
+        }
+
+        void flush( QPolygonF &out )
+        {
+            while ( numPending() > 0 )
+            {
+                if ( d_candidate == numPending() - 1 )
+                {
+                    out += d_pending.last();
+
+                    d_pending.clear();
+                    d_first = 0;
+                }
+                else
+                {
+                    // the points behind the candidate are not covered
+                    nextAnchor( out );
+                    process( 0, out );
+                }
+            }
+
+            resetCone();
+        }
+
+    private:
+        void resetCone()
+        {
+            d_hasCone = false;
+            d_candidate = -1;
+            d_maxDistance2 = 0.0;
+        }
+
+        inline int numPending() const
+        {
+            return d_pending.size() - d_first;
+        }
+
+        void nextAnchor( QPolygonF &out )
+        {
+            d_anchor = d_pending[d_first + d_candidate];
+            out += d_anchor;
+
+            d_first += d_candidate + 1;
+
+            if ( d_first > qwtMaxPending && 2 * d_first > d_pending.size() )
+            {
+                // removing the points before the anchor rarely,
+                // instead of moving the pending points each time
+
+                d_pending.remove( 0, d_first );
+                d_first = 0;
+            }
+
+            resetCone();
+        }
+
+        void process( int index, QPolygonF &out )
+        {
+            while ( index < numPending() )
+            {
+                if ( add( d_pending[d_first + index], index ) )
+                {
+                    index++;
+                }
+                else
+                {
+                    nextAnchor( out );
+                    index = 0;
+                }
+            }
+        }
+
+        inline void cone( double dx, double dy, double distance2,
+            double &loX, double &loY, double &hiX, double &hiY ) const
+        {
+            // directions, where the point is at the tolerance
+
+            const double distance = qSqrt( distance2 );
+
+            const double ux = dx / distance;
+            const double uy = dy / distance;
+
+            const double sinA = d_tolerance / distance;
+            const double cosA = qSqrt( qMax( 1.0 - sinA * sinA, 0.0 ) );
+
+            loX = ux * cosA + uy * sinA;
+            loY = uy * cosA - ux * sinA;
+
+            hiX = ux * cosA - uy * sinA;
+            hiY = uy * cosA + ux * sinA;
+        }
+
+        bool add( const QPointF &point, int index )
+        {
+            const double dx = point.x() - d_anchor.x();
+            const double dy = point.y() - d_anchor.y();
+            const double distance2 = dx * dx + dy * dy;
+
+            if ( distance2 <= d_tolerance2 )
+            {
+                // close to the anchor - in tolerance for any direction
+
+                if ( !d_hasCone )
+                    d_candidate = index;
+
+                return true;
+            }
+
+            if ( !d_hasCone )
+            {
+                cone( dx, dy, distance2, d_loX, d_loY, d_hiX, d_hiY );
+                d_hasCone = true;
+
+                d_maxDistance2 = distance2;
+                d_candidate = index;
+
+                return true;
+            }
+
+            if ( d_loX * dy - d_loY * dx < 0.0 || dx * d_hiY - dy * d_hiX < 0.0 )
+                return false;
+
+            double loX, loY, hiX, hiY;
+            cone( dx, dy, distance2, loX, loY, hiX, hiY );
+
+            if ( d_loX * loY - d_loY * loX > 0.0 )
+            {
+                d_loX = loX;
+                d_loY = loY;
+            }
+
+            if ( hiX * d_hiY - hiY * d_hiX > 0.0 )
+            {
+                d_hiX = hiX;
+                d_hiY = hiY;
+            }
+
+            /*
+              Only the most distant point can be the next anchor.
+              Otherwise points between might be beyond the end of the line.
+             */
+            if ( distance2 >= d_maxDistance2 )
+            {
+                d_maxDistance2 = distance2;
+                d_candidate = index;
+            }
+
+            return true;
+        }
+
+        double d_tolerance;
+        double d_tolerance2;
+
+        bool d_hasAnchor;
+        QPointF d_anchor;
+
+        // the points since the anchor start at d_first
+        QVector<QPointF> d_pending;
+        int d_first;
+
+        bool d_hasCone;
+        double d_loX, d_loY;
+        double d_hiX, d_hiY;
+
+        double d_maxDistance2;
+        int d_candidate;
+    };
+}
+
+static QPolygonF qwtSimplify( double tolerance,
+    const QPointF *points, int numPoints )
+{
+    QPolygonF simplified;
+
+    Simplifier simplifier( tolerance );
+    for ( int i = 0; i < numPoints; i++ )
+        simplifier.append( points[i], simplified );
+
+    simplifier.flush( simplified );
+
+    return simplified;
+}
+
+class QwtStreamingCurveFitter::PrivateData
+{
+public:
+    PrivateData():
+        tolerance( 1.0 ),
+        chunkSize( 0 ),
+        simplifier( 1.0 )
+    {
+    }
+
+    double tolerance;
+    uint chunkSize;
+
+    Simplifier simplifier;
+};
+
+/*!
+   Constructor
+
+   \param tolerance Tolerance
+   \sa setTolerance(), tolerance()
+*/
+QwtStreamingCurveFitter::QwtStreamingCurveFitter( double tolerance ):
+    QwtCurveFitter( QwtCurveFitter::Polygon )
+{
+    d_data = new PrivateData;
+    setTolerance( tolerance );
+}
+
+//! Destructor
+QwtStreamingCurveFitter::~QwtStreamingCurveFitter()
+{
+    delete d_data;
+}
+
+/*!
+ Assign the tolerance
+
+ The tolerance is the maximum distance, that is acceptable
+ between the original curve and the smoothed curve.
+
+ Increasing the tolerance will reduce the number of the
+ resulting points.
+
+ \param tolerance Tolerance
+
+ \sa tolerance()
+ \note Assigning a tolerance resets the stream
+*/
+void QwtStreamingCurveFitter::setTolerance( double tolerance )
+{
+    d_data->tolerance = qMax( tolerance, 0.0 );
+    resetStream();
+}
+
+/*!
+  \return Tolerance
+  \sa setTolerance()
+*/
+double QwtStreamingCurveFitter::tolerance() const
+{
+    return d_data->tolerance;
+}
+
+/*!
+ Limit the number of points passed to a run of the algorithm
+
+ The chunks are simplified by concurrent threads. For a chunk size of 0
+ polygons with more than 100000 points are split into one chunk
+ for each thread. The points at the borders of the chunks
+ are always part of the result.
+
+ \param numPoints Maximum for the number of points passed to the algorithm
+
+ \sa chunkSize()
+*/
+void QwtStreamingCurveFitter::setChunkSize( uint numPoints )
+{
+    if ( numPoints > 0 )
+        numPoints = qMax( numPoints, 3U );
+
+    d_data->chunkSize = numPoints;
+}
+
+/*!
+  \return Maximum for the number of points passed to a run
+          of the algorithm - or 0, when it is chosen automatically
+  \sa setChunkSize()
+*/
+uint QwtStreamingCurveFitter::chunkSize() const
+{
+    return d_data->chunkSize;
+}
+
+/*!
+  \param points Series of data points
+  \return Curve points
+  \sa fitCurvePath(), appendPoints()
+*/
+QPolygonF QwtStreamingCurveFitter::fitCurve( const QPolygonF &points ) const
+{
+    const int numPoints = points.size();
+    if ( numPoints <= 2 )
+        return points;
+
+    int chunkSize = d_data->chunkSize;
+    if ( chunkSize == 0 )
+    {
+        chunkSize = numPoints;
+
+#if !defined(QT_NO_QFUTURE)
+        if ( numPoints >= 2 * qwtMinChunkSize )
+        {
+            const int numThreads = QThread::idealThreadCount();
+            if ( numThreads > 1 )
+                chunkSize = ( numPoints - 1 ) / numThreads + 2;
+        }
+#endif
+    }
+
+    if ( chunkSize >= numPoints )
+        return qwtSimplify( d_data->tolerance, points.constData(), numPoints );
+
+    // consecutive chunks are sharing their border points
+
+    const int step = chunkSize - 1;
+
+    QVector<QPolygonF> chunks;
+
+#if !defined(QT_NO_QFUTURE)
+    QList< QFuture<QPolygonF> > futures;
+#endif
+
+    for ( int i = 0; i < numPoints - 1; i += step )
+    {
+        const QPointF *p = points.constData() + i;
+        const int n = qMin( chunkSize, numPoints - i );
+
+#if !defined(QT_NO_QFUTURE)
+        futures += QtConcurrent::run( &qwtSimplify, d_data->tolerance, p, n );
+#else
+        chunks += qwtSimplify( d_data->tolerance, p, n );
+#endif
+    }
+
+#if !defined(QT_NO_QFUTURE)
+    for ( int i = 0; i < futures.size(); i++ )
+        chunks += futures[i].result();
+#endif
+
+    int numFitted = 0;
+    for ( int i = 0; i < chunks.size(); i++ )
+        numFitted += chunks[i].size();
+
+    QPolygonF fittedPoints;
+    fittedPoints.reserve( numFitted );
+
+    for ( int i = 0; i < chunks.size(); i++ )
+    {
+        const QPolygonF &chunk = chunks[i];
+
+        /*
+          The shared border point is only at the beginning of a chunk,
+          when it is valid. Otherwise the chunk starts with the first
+          valid point behind the border - or is empty.
+         */
+        int j = 0;
+        if ( !chunk.isEmpty() && !fittedPoints.isEmpty()
+            && chunk[0] == fittedPoints.last() )
+        {
+            j = 1;
+        }
+
+        for ( ; j < chunk.size(); j++ )
+            fittedPoints += chunk[j];
+    }
+
+    return fittedPoints;
+}
+
+/*!
+  \param points Series of data points
+  \return Curve path
+  \sa fitCurve()
+*/
+QPainterPath QwtStreamingCurveFitter::fitCurvePath( const QPolygonF &points ) const
+{
+    QPainterPath path;
+    path.addPolygon( fitCurve( points ) );
+    return path;
+}
+
+/*!
+  \brief Append points to the stream
+
+  The points are simplified with the points, that have been appended
+  before. As the last points might be affected by the following ones,
+  they are not part of the result before they are finally decided.
+
+  \param points Points to be appended
+  \return Points of the simplified polygon, that have been decided
+          by appending the points
+
+  \sa streamTail(), resetStream()
+*/
+QPolygonF QwtStreamingCurveFitter::appendPoints( const QPolygonF &points )
+{
+    QPolygonF simplified;
+
+    for ( int i = 0; i < points.size(); i++ )
+        d_data->simplifier.append( points[i], simplified );
+
+    return simplified;
+}
+
+/*!
+  \brief Points to complete the simplified polygon of the stream
+
+  All points, that have been returned by appendPoints(), followed by
+  the tail are the simplified polygon for all points, that have been
+  appended to the stream. The stream itself is not modified.
+
+  \return Undecided points at the end of the simplified polygon
+  \sa appendPoints()
+*/
+QPolygonF QwtStreamingCurveFitter::streamTail() const
+{
+    QPolygonF tail;
+
+    Simplifier simplifier = d_data->simplifier;
+    simplifier.flush( tail );
+
+    return tail;
+}
+
+/*!
+  \brief Discard all points of the stream
+
+  The next point passed to appendPoints() starts a new polygon.
+  \sa appendPoints()
+*/
+void QwtStreamingCurveFitter::resetStream()
+{
+    d_data->simplifier = Simplifier( d_data->tolerance );
+}
@@ -0,0 +1,78 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_STREAMING_CURVE_FITTER_H
+#define QWT_STREAMING_CURVE_FITTER_H
+
+#include "qwt_curve_fitter.h"
+
+/*!
+  \brief A curve fitter, that simplifies a polygon in one pass
+
+  Like QwtWeedingCurveFitter the fitter reduces a polygon to a subset
+  of its points, where no point of the original polygon has a larger
+  distance to the simplified polygon than the tolerance.
+
+  But instead of splitting the polygon recursively the points are
+  processed one after the other: for each point the directions from the
+  last point of the simplified polygon are narrowed down to a cone, that
+  keeps all points in between inside of the tolerance. A new point is added,
+  when the cone would become empty.
+
+  Then the points behind the new point have to be processed again.
+  As a new point is forced, when more than 1024 points have been
+  collected since the last one, each point is revisited at most 1024 times.
+  So the worst case is O(n) with a large constant, while for
+  all practical input each point is processed only a few times.
+
+  The result is not as minimal as the one of the Douglas and Peucker
+  algorithm, but for huge polygons the fitter is faster by orders of
+  magnitude. Large polygons are split into chunks, that are simplified by
+  concurrent threads ( see setChunkSize() ).
+
+  As the algorithm never looks ahead it can also be fed with
+  growing series - f.e. from a data acquisition:
+
+  \code
+    QwtStreamingCurveFitter fitter( 0.5 );
+
+    void Acquisition::append( const QPolygonF &points )
+    {
+        simplified += fitter.appendPoints( points );
+        curve->setSamples( simplified + fitter.streamTail() );
+    }
+  \endcode
+
+  \sa QwtWeedingCurveFitter
+*/
+class QWT_EXPORT QwtStreamingCurveFitter: public QwtCurveFitter
+{
+public:
+    explicit QwtStreamingCurveFitter( double tolerance = 1.0 );
+    virtual ~QwtStreamingCurveFitter();
+
+    void setTolerance( double );
+    double tolerance() const;
+
+    void setChunkSize( uint );
+    uint chunkSize() const;
+
+    virtual QPolygonF fitCurve( const QPolygonF & ) const;
+    virtual QPainterPath fitCurvePath( const QPolygonF & ) const;
+
+    QPolygonF appendPoints( const QPolygonF & );
+    QPolygonF streamTail() const;
+    void resetStream();
+
+private:
+    class PrivateData;
+    PrivateData *d_data;
+};
+
+#endif
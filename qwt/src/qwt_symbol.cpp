@@ -10,12 +10,16 @@
 #include "qwt_symbol.h"
 #include "qwt_painter.h"
 #include "qwt_graphic.h"
+#include "qwt_plot_profile.h"
+#include "qwt_sprite_renderer.h"
 #include <qapplication.h>
+#include <qthread.h>
 #include <qpainter.h>
 #include <qpainterpath.h>
 #include <qpixmap.h>
 #include <qpaintengine.h>
 #include <qmath.h>
+#include <qimage.h>
 #ifndef QWT_NO_SVG
 #include <qsvgrenderer.h>
 #endif
@@ -31,6 +35,9 @@ namespace QwtTriangle
     };
 }
 
+// minimum number of symbols, where stamping is used
+static const int qwtStampThreshold = 100;
+
 static QwtGraphic qwtPathGraphic( const QPainterPath &path, 
     const QPen &pen, const QBrush& brush )
 {
@@ -829,6 +836,7 @@ public:
     {
         QwtSymbol::CachePolicy policy;
         QPixmap pixmap;
+        QImage sprite;
 
     } cache;
 };
@@ -1386,12 +1394,77 @@ void QwtSymbol::drawSymbols( QPainter *painter,
         }
     }
 
+    const bool isGuiThread = qApp != NULL
+        && QThread::currentThread() == qApp->thread();
+
+    if ( useCache && numPoints >= qwtStampThreshold
+        && !boundingRect().isEmpty()
+        && QwtSpriteRenderer::isSupported( painter ) )
+    {
+        /*
+          Many symbols: instead of painting the pixmap for each point
+          we blend a pre-rendered sprite into an image, that is painted
+          in one go. As we don't need a QPixmap, this is also possible
+          from other threads than the GUI thread - but without
+          modifying the cache.
+
+          isSupported() is false for devices with a pixel ratio != 1,
+          so the sprite can be rendered in device independent pixels.
+         */
+
+        const QRect br = boundingRect();
+
+        QImage sprite;
+        if ( isGuiThread )
+            sprite = d_data->cache.sprite;
+
+        QwtPlotProfiler::count( sprite.isNull()
+            ? QwtPlotProfiler::CacheMiss : QwtPlotProfiler::CacheHit );
+
+        if ( sprite.isNull() )
+        {
+            sprite = QImage( br.size(), QImage::Format_ARGB32_Premultiplied );
+            sprite.fill( 0 );
+
+            QPainter p( &sprite );
+            p.setRenderHints( painter->renderHints() );
+            p.translate( -br.topLeft() );
+
+            const QPointF pos( 0.0, 0.0 );
+            renderSymbols( &p, &pos, 1 );
+
+            p.end();
+
+            if ( isGuiThread )
+                d_data->cache.sprite = sprite;
+        }
+
+        QwtSpriteRenderer renderer;
+        renderer.addSprite( sprite, br.topLeft() );
+
+        if ( renderer.render( painter, points, NULL, numPoints ) )
+        {
+            return;
+        }
+    }
+
+    if ( useCache && !isGuiThread )
+    {
+        // QPixmap is not available outside of the GUI thread,
+        // f.e. when rendering a QwtPlotScene from a worker thread
+
+        useCache = false;
+    }
+
     if ( useCache )
     {
         const QRect br = boundingRect();
 
         const QRect rect( 0, 0, br.width(), br.height() );
 
+        QwtPlotProfiler::count( d_data->cache.pixmap.isNull()
+            ? QwtPlotProfiler::CacheMiss : QwtPlotProfiler::CacheHit );
+
         if ( d_data->cache.pixmap.isNull() )
         {
             d_data->cache.pixmap = QwtPainter::backingStore( NULL, br.size() );
@@ -1776,6 +1849,9 @@ void QwtSymbol::invalidateCache()
 {
     if ( !d_data->cache.pixmap.isNull() )
         d_data->cache.pixmap = QPixmap();
+
+    if ( !d_data->cache.sprite.isNull() )
+        d_data->cache.sprite = QImage();
 }
 
 /*!
@@ -141,6 +141,9 @@ public:
 
       \sa setCachePolicy(), cachePolicy()
 
+      When painting many symbols at once the cached symbol is
+      blended as a sprite into an image, that is painted in one go.
+
       \note The policy has no effect, when the symbol is painted 
             to a vector graphics format ( PDF, SVG ).
       \warning Since Qt 4.8 raster is the default backend on X11
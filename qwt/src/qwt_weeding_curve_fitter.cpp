@@ -9,37 +9,184 @@
 
 #include "qwt_weeding_curve_fitter.h"
 #include "qwt_math.h"
-#include <qstack.h>
 #include <qvector.h>
+#include <qthread.h>
+#include <qfuture.h>
+#include <qtconcurrentrun.h>
 
 #if QT_VERSION < 0x040601
 #define qFabs(x) ::fabs(x)
 #endif
 
-class QwtWeedingCurveFitter::PrivateData
+// ranges with less points are not split for concurrent threads
+static const int qwtMinParallelRange = 5000;
+
+namespace
 {
-public:
-    PrivateData():
-        tolerance( 1.0 ),
-        chunkSize( 0 )
+    class Line
+    {
+    public:
+        Line( int i1 = 0, int i2 = 0 ):
+            from( i1 ),
+            to( i2 )
+        {
+        }
+
+        int from;
+        int to;
+    };
+
+    /*
+      All memory needed for simplifying a polygon of n points
+      is allocated in one block:
+
+      - n lines for the stacks of the subdivision.
+        As the lines on a stack are disjoint, a range [from, to]
+        never needs more than to - from lines. So the concurrent runs
+        for different ranges can use the lines starting at "from".
+
+      - n flags for the points, that are part of the result
+     */
+    class Arena
+    {
+    public:
+        explicit Arena( int numPoints ):
+            d_numPoints( numPoints ),
+            d_buffer( numPoints + numPoints / int( sizeof( Line ) ) + 1 )
+        {
+            qMemSet( usePoint(), 0, numPoints );
+        }
+
+        inline Line *lines()
+        {
+            return d_buffer.data();
+        }
+
+        inline uchar *usePoint()
+        {
+            return reinterpret_cast<uchar *>( d_buffer.data() + d_numPoints );
+        }
+
+    private:
+        const int d_numPoints;
+        QVector<Line> d_buffer;
+    };
+
+    // Helper class to work around the 5 parameters
+    // limitation of QtConcurrent::run()
+    class SimplifyCommand
+    {
+    public:
+        const QPointF *points;
+        double toleranceSqr;
+
+        Line *lines;
+        uchar *usePoint;
+    };
+}
+
+static int qwtFarthestPoint( const QPointF *p,
+    const Line &r, double toleranceSqr )
+{
+    // the index of the point with the maximum distance, or -1
+    // when all points between are inside of the tolerance
+
+    const double vecX = p[r.to].x() - p[r.from].x();
+    const double vecY = p[r.to].y() - p[r.from].y();
+
+    const double vecLength = qSqrt( vecX * vecX + vecY * vecY );
+
+    const double unitVecX = ( vecLength != 0.0 ) ? vecX / vecLength : 0.0;
+    const double unitVecY = ( vecLength != 0.0 ) ? vecY / vecLength : 0.0;
+
+    double maxDistSqr = 0.0;
+    int nVertexIndexMaxDistance = r.from + 1;
+    for ( int i = r.from + 1; i < r.to; i++ )
     {
+        //compare to anchor
+        const double fromVecX = p[i].x() - p[r.from].x();
+        const double fromVecY = p[i].y() - p[r.from].y();
+
+        double distToSegmentSqr;
+        if ( fromVecX * unitVecX + fromVecY * unitVecY < 0.0 )
+        {
+            distToSegmentSqr = fromVecX * fromVecX + fromVecY * fromVecY;
+        }
+        else
+        {
+            const double toVecX = p[i].x() - p[r.to].x();
+            const double toVecY = p[i].y() - p[r.to].y();
+            const double toVecLength = toVecX * toVecX + toVecY * toVecY;
+
+            const double s = toVecX * ( -unitVecX ) + toVecY * ( -unitVecY );
+            if ( s < 0.0 )
+            {
+                distToSegmentSqr = toVecLength;
+            }
+            else
+            {
+                distToSegmentSqr = qFabs( toVecLength - s * s );
+            }
+        }
+
+        if ( maxDistSqr < distToSegmentSqr )
+        {
+            maxDistSqr = distToSegmentSqr;
+            nVertexIndexMaxDistance = i;
+        }
     }
 
-    double tolerance;
-    uint chunkSize;
-};
+    if ( maxDistSqr <= toleranceSqr )
+        return -1;
+
+    return nVertexIndexMaxDistance;
+}
+
+static void qwtSimplifyRange( const SimplifyCommand &command, int from, int to )
+{
+    /*
+      The final lines of the subdivision are a partition of [from, to]:
+      flagging their first points only, the concurrent runs never write
+      to the same flag. The last point is flagged by the caller.
+     */
+
+    Line *stack = command.lines + from;
+    int top = 0;
+
+    stack[top++] = Line( from, to );
 
-class QwtWeedingCurveFitter::Line
+    while ( top > 0 )
+    {
+        const Line r = stack[--top];
+
+        const int index = qwtFarthestPoint(
+            command.points, r, command.toleranceSqr );
+
+        if ( index < 0 )
+        {
+            command.usePoint[r.from] = 1;
+        }
+        else
+        {
+            stack[top++] = Line( r.from, index );
+            stack[top++] = Line( index, r.to );
+        }
+    }
+}
+
+class QwtWeedingCurveFitter::PrivateData
 {
 public:
-    Line( int i1 = 0, int i2 = 0 ):
-        from( i1 ),
-        to( i2 )
+    PrivateData():
+        tolerance( 1.0 ),
+        chunkSize( 0 ),
+        numThreads( 1 )
     {
     }
 
-    int from;
-    int to;
+    double tolerance;
+    uint chunkSize;
+    uint numThreads;
 };
 
 /*!
@@ -118,6 +265,33 @@ uint QwtWeedingCurveFitter::chunkSize() const
     return d_data->chunkSize;
 }
 
+/*!
+ Set the number of threads for simplifying a polygon
+
+ After subdividing a polygon into enough independent ranges, the
+ ranges are simplified by concurrent threads. Polygons with less than
+ 10000 points are always simplified by the calling thread.
+
+ \param numThreads Maximum number of threads. For 0 the
+                   number of threads is QThread::idealThreadCount().
+
+ \sa numThreads(), setChunkSize()
+ \note The default setting is 1 - no concurrent threads.
+*/
+void QwtWeedingCurveFitter::setNumThreads( uint numThreads )
+{
+    d_data->numThreads = numThreads;
+}
+
+/*!
+  \return Maximum number of threads for simplifying a polygon
+  \sa setNumThreads()
+*/
+uint QwtWeedingCurveFitter::numThreads() const
+{
+    return d_data->numThreads;
+}
+
 /*!
   \param points Series of data points
   \return Curve points
@@ -157,84 +331,106 @@ QPainterPath QwtWeedingCurveFitter::fitCurvePath( const QPolygonF &points ) cons
 
 QPolygonF QwtWeedingCurveFitter::simplify( const QPolygonF &points ) const
 {
-    const double toleranceSqr = d_data->tolerance * d_data->tolerance;
+    const int nPoints = points.size();
+    if ( nPoints <= 2 )
+        return points;
 
-    QStack<Line> stack;
-    stack.reserve( 500 );
+    Arena arena( nPoints );
 
-    const QPointF *p = points.data();
-    const int nPoints = points.size();
+    SimplifyCommand command;
+    command.points = points.constData();
+    command.toleranceSqr = d_data->tolerance * d_data->tolerance;
+    command.lines = arena.lines();
+    command.usePoint = arena.usePoint();
 
-    QVector<bool> usePoint( nPoints, false );
+    int numThreads = 1;
 
-    stack.push( Line( 0, nPoints - 1 ) );
+#if !defined(QT_NO_QFUTURE)
+    numThreads = d_data->numThreads;
+    if ( numThreads == 0 )
+        numThreads = QThread::idealThreadCount();
+#endif
 
-    while ( !stack.isEmpty() )
+    if ( numThreads <= 1 || nPoints < 2 * qwtMinParallelRange )
+    {
+        qwtSimplifyRange( command, 0, nPoints - 1 );
+    }
+    else
     {
-        const Line r = stack.pop();
+        /*
+          Subdividing the largest ranges, until there are enough
+          independent ranges to keep all threads busy. The thread pool
+          assigns the ranges to the threads, as soon as they are idle.
+         */
 
-        // initialize line segment
-        const double vecX = p[r.to].x() - p[r.from].x();
-        const double vecY = p[r.to].y() - p[r.from].y();
+        QVector<Line> ranges;
+        ranges += Line( 0, nPoints - 1 );
 
-        const double vecLength = qSqrt( vecX * vecX + vecY * vecY );
+        while ( ranges.size() < 4 * numThreads )
+        {
+            int maxIndex = 0;
+            for ( int i = 1; i < ranges.size(); i++ )
+            {
+                const Line &r = ranges[i];
+                if ( r.to - r.from > ranges[maxIndex].to - ranges[maxIndex].from )
+                    maxIndex = i;
+            }
 
-        const double unitVecX = ( vecLength != 0.0 ) ? vecX / vecLength : 0.0;
-        const double unitVecY = ( vecLength != 0.0 ) ? vecY / vecLength : 0.0;
+            const Line r = ranges[maxIndex];
+            if ( r.to - r.from < qwtMinParallelRange )
+                break;
 
-        double maxDistSqr = 0.0;
-        int nVertexIndexMaxDistance = r.from + 1;
-        for ( int i = r.from + 1; i < r.to; i++ )
-        {
-            //compare to anchor
-            const double fromVecX = p[i].x() - p[r.from].x();
-            const double fromVecY = p[i].y() - p[r.from].y();
+            const int index = qwtFarthestPoint(
+                command.points, r, command.toleranceSqr );
 
-            double distToSegmentSqr;
-            if ( fromVecX * unitVecX + fromVecY * unitVecY < 0.0 )
+            if ( index < 0 )
             {
-                distToSegmentSqr = fromVecX * fromVecX + fromVecY * fromVecY;
+                command.usePoint[r.from] = 1;
+                ranges.remove( maxIndex );
+
+                if ( ranges.isEmpty() )
+                    break;
             }
             else
             {
-                const double toVecX = p[i].x() - p[r.to].x();
-                const double toVecY = p[i].y() - p[r.to].y();
-                const double toVecLength = toVecX * toVecX + toVecY * toVecY;
-
-                const double s = toVecX * ( -unitVecX ) + toVecY * ( -unitVecY );
-                if ( s < 0.0 )
-                {
-                    distToSegmentSqr = toVecLength;
-                }
-                else
-                {
-                    distToSegmentSqr = qFabs( toVecLength - s * s );
-                }
-            }
-
-            if ( maxDistSqr < distToSegmentSqr )
-            {
-                maxDistSqr = distToSegmentSqr;
-                nVertexIndexMaxDistance = i;
+                ranges[maxIndex] = Line( r.from, index );
+                ranges.insert( maxIndex + 1, Line( index, r.to ) );
             }
         }
-        if ( maxDistSqr <= toleranceSqr )
-        {
-            usePoint[r.from] = true;
-            usePoint[r.to] = true;
-        }
-        else
+
+#if !defined(QT_NO_QFUTURE)
+        QList< QFuture<void> > futures;
+        for ( int i = 1; i < ranges.size(); i++ )
         {
-            stack.push( Line( r.from, nVertexIndexMaxDistance ) );
-            stack.push( Line( nVertexIndexMaxDistance, r.to ) );
+            futures += QtConcurrent::run( &qwtSimplifyRange,
+                command, ranges[i].from, ranges[i].to );
         }
+#endif
+
+        if ( !ranges.isEmpty() )
+            qwtSimplifyRange( command, ranges[0].from, ranges[0].to );
+
+#if !defined(QT_NO_QFUTURE)
+        for ( int i = 0; i < futures.size(); i++ )
+            futures[i].waitForFinished();
+#endif
     }
 
-    QPolygonF stripped;
+    command.usePoint[nPoints - 1] = 1;
+
+    const QPointF *p = command.points;
+
+    int numUsed = 0;
+    for ( int i = 0; i < nPoints; i++ )
+        numUsed += command.usePoint[i];
+
+    QPolygonF stripped( numUsed );
+    QPointF *s = stripped.data();
+
     for ( int i = 0; i < nPoints; i++ )
     {
-        if ( usePoint[i] )
-            stripped += p[i];
+        if ( command.usePoint[i] )
+            *s++ = p[i];
     }
 
     return stripped;
@@ -27,6 +27,10 @@
   for these smaller parts. The disadvantage of having no interpolation
   at the borders is for most use cases irrelevant.
 
+  As the subdivisions of the polygon are independent from each other
+  they can be processed by concurrent threads ( setNumThreads() ).
+  The result is the same as for a single thread.
+
   The smoothed curve consists of a subset of the points that defined the
   original curve.
 
@@ -47,14 +51,15 @@ public:
     void setChunkSize( uint );
     uint chunkSize() const;
 
+    void setNumThreads( uint );
+    uint numThreads() const;
+
     virtual QPolygonF fitCurve( const QPolygonF & ) const;
     virtual QPainterPath fitCurvePath( const QPolygonF & ) const;
 
 private:
     virtual QPolygonF simplify( const QPolygonF & ) const;
 
-    class Line;
-
     class PrivateData;
     PrivateData *d_data;
 };
@@ -33,6 +33,7 @@ HEADERS += \
     qwt_picker.h \
     qwt_picker_machine.h \
     qwt_pixel_matrix.h \
+    qwt_plot_profile.h \
     qwt_point_3d.h \
     qwt_point_polar.h \
     qwt_round_scale_draw.h \
@@ -40,13 +41,16 @@ HEADERS += \
     qwt_scale_draw.h \
     qwt_scale_engine.h \
     qwt_scale_map.h \
+    qwt_scratch_pool.h \
     qwt_spline.h \
     qwt_spline_basis.h \
     qwt_spline_parametrization.h \
     qwt_spline_local.h \
+    qwt_spline_local_incremental.h \
     qwt_spline_cubic.h \
     qwt_spline_pleasing.h \
     qwt_spline_polynomial.h \
+    qwt_sprite_renderer.h \
     qwt_symbol.h \
     qwt_system_clock.h \
     qwt_text_engine.h \
@@ -78,6 +82,7 @@ SOURCES += \
     qwt_picker.cpp \
     qwt_picker_machine.cpp \
     qwt_pixel_matrix.cpp \
+    qwt_plot_profile.cpp \
     qwt_point_3d.cpp \
     qwt_point_polar.cpp \
     qwt_round_scale_draw.cpp \
@@ -85,12 +90,15 @@ SOURCES += \
     qwt_scale_draw.cpp \
     qwt_scale_map.cpp \
     qwt_scale_engine.cpp \
+    qwt_scratch_pool.cpp \
     qwt_spline.cpp \
     qwt_spline_basis.cpp \
     qwt_spline_parametrization.cpp \
     qwt_spline_local.cpp \
+    qwt_spline_local_incremental.cpp \
     qwt_spline_cubic.cpp \
     qwt_spline_pleasing.cpp \
+    qwt_sprite_renderer.cpp \
     qwt_symbol.cpp \
     qwt_system_clock.cpp \
     qwt_text_engine.cpp \
@@ -105,6 +113,7 @@ contains(QWT_CONFIG, QwtPlot) {
     HEADERS += \
         qwt_curve_fitter.h \
         qwt_spline_curve_fitter.h \
+        qwt_streaming_curve_fitter.h \
         qwt_weeding_curve_fitter.h \
         qwt_event_pattern.h \
         qwt_abstract_legend.h \
@@ -113,6 +122,7 @@ contains(QWT_CONFIG, QwtPlot) {
         qwt_legend_label.h \
         qwt_plot.h \
         qwt_plot_renderer.h \
+        qwt_plot_scene.h \
         qwt_plot_curve.h \
         qwt_plot_dict.h \
         qwt_plot_directpainter.h \
@@ -143,6 +153,7 @@ contains(QWT_CONFIG, QwtPlot) {
         qwt_plot_magnifier.h \
         qwt_plot_rescaler.h \
         qwt_point_mapper.h \
+        qwt_spatial_index.h \
         qwt_raster_data.h \
         qwt_matrix_raster_data.h \
         qwt_sampling_thread.h \
@@ -150,11 +161,13 @@ contains(QWT_CONFIG, QwtPlot) {
         qwt_series_data.h \
         qwt_series_store.h \
         qwt_point_data.h \
+        qwt_histogram_data.h \
         qwt_scale_widget.h 
 
     SOURCES += \
         qwt_curve_fitter.cpp \
         qwt_spline_curve_fitter.cpp \
+        qwt_streaming_curve_fitter.cpp \
         qwt_weeding_curve_fitter.cpp \
         qwt_abstract_legend.cpp \
         qwt_legend.cpp \
@@ -162,6 +175,7 @@ contains(QWT_CONFIG, QwtPlot) {
         qwt_legend_label.cpp \
         qwt_plot.cpp \
         qwt_plot_renderer.cpp \
+        qwt_plot_scene.cpp \
         qwt_plot_xml.cpp \
         qwt_plot_axis.cpp \
         qwt_plot_curve.cpp \
@@ -194,11 +208,13 @@ contains(QWT_CONFIG, QwtPlot) {
         qwt_plot_magnifier.cpp \
         qwt_plot_rescaler.cpp \
         qwt_point_mapper.cpp \
+        qwt_spatial_index.cpp \
         qwt_raster_data.cpp \
         qwt_matrix_raster_data.cpp \
         qwt_sampling_thread.cpp \
         qwt_series_data.cpp \
         qwt_point_data.cpp \
+        qwt_histogram_data.cpp \
         qwt_scale_widget.cpp
 
     contains(QWT_CONFIG, QwtOpenGL) {
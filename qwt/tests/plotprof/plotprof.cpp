@@ -0,0 +1,724 @@
+/*
+   Headless benchmarks for the rendering code of the plot items
+
+   All items are rendered into a QImage of a fixed size - no widget
+   is shown. With Qt5 the "offscreen" platform plugin is used, when no
+   other platform has been requested, so that the benchmarks can run
+   on build servers without any display.
+
+   The results are written to stdout as tab separated values,
+   one line per benchmark:
+
+       suite  case  points  iterations  median_ms  min_ms  points_per_s
+
+   Options:
+
+       --max-points <n>     Largest number of points for curves ( 1000000 )
+       --min-time <ms>      Minimum time for measuring a case ( 500 )
+       --max-iterations <n> Maximum number of iterations per case ( 50 )
+       --size <w>x<h>       Size of the image ( 800x600 )
+       --filter <regexp>    Run the cases matching "suite/case" only
+ */
+
+#include <qwt_plot.h>
+#include <qwt_plot_curve.h>
+#include <qwt_plot_spectrogram.h>
+#include <qwt_matrix_raster_data.h>
+#include <qwt_color_map.h>
+#include <qwt_point_data.h>
+#include <qwt_symbol.h>
+#include <qwt_weeding_curve_fitter.h>
+#include <qwt_streaming_curve_fitter.h>
+#include <qwt_scale_draw.h>
+#include <qwt_scale_engine.h>
+#include <qwt_scale_map.h>
+#include <qwt_legend.h>
+#include <qwt_math.h>
+#include <QApplication>
+#include <QImage>
+#include <QPainter>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QStringList>
+#include <QRegExp>
+#include <QVector>
+#include <algorithm>
+
+class SineData: public QwtSyntheticPointData
+{
+public:
+    SineData( size_t size ):
+        QwtSyntheticPointData( size, QwtInterval( 0.0, 100.0 ) )
+    {
+    }
+
+    virtual double y( double x ) const
+    {
+        return qSin( x ) * qCos( 7.3 * x );
+    }
+};
+
+class Task
+{
+public:
+    virtual ~Task()
+    {
+    }
+
+    virtual void run( QPainter * ) = 0;
+};
+
+class ItemTask: public Task
+{
+public:
+    ItemTask( const QwtPlotItem *item, const QwtScaleMap &xMap,
+            const QwtScaleMap &yMap, const QRectF &canvasRect ):
+        d_item( item ),
+        d_xMap( xMap ),
+        d_yMap( yMap ),
+        d_canvasRect( canvasRect )
+    {
+    }
+
+    virtual void run( QPainter *painter )
+    {
+        painter->setRenderHint( QPainter::Antialiasing,
+            d_item->testRenderHint( QwtPlotItem::RenderAntialiased ) );
+
+        d_item->draw( painter, d_xMap, d_yMap, d_canvasRect );
+    }
+
+private:
+    const QwtPlotItem *d_item;
+    const QwtScaleMap d_xMap;
+    const QwtScaleMap d_yMap;
+    const QRectF d_canvasRect;
+};
+
+class SymbolTask: public Task
+{
+public:
+    SymbolTask( const QwtSymbol *symbol, const QPolygonF &points ):
+        d_symbol( symbol ),
+        d_points( points )
+    {
+    }
+
+    virtual void run( QPainter *painter )
+    {
+        d_symbol->drawSymbols( painter, d_points );
+    }
+
+private:
+    const QwtSymbol *d_symbol;
+    const QPolygonF d_points;
+};
+
+class FitterTask: public Task
+{
+public:
+    FitterTask( const QwtCurveFitter *fitter, const QPolygonF &points ):
+        d_fitter( fitter ),
+        d_points( points )
+    {
+    }
+
+    virtual void run( QPainter * )
+    {
+        d_fitted = d_fitter->fitCurve( d_points );
+    }
+
+private:
+    const QwtCurveFitter *d_fitter;
+    const QPolygonF d_points;
+    QPolygonF d_fitted;
+};
+
+class ScaleTask: public Task
+{
+public:
+    ScaleTask( QwtScaleEngine *engine,
+            QwtScaleDraw::Alignment alignment, const QRectF &rect ):
+        d_engine( engine ),
+        d_count( 0 )
+    {
+        d_scaleDraw.setAlignment( alignment );
+        d_scaleDraw.setTransformation( engine->transformation() );
+
+        if ( d_scaleDraw.orientation() == Qt::Horizontal )
+        {
+            d_scaleDraw.move( rect.left(), rect.center().y() );
+            d_scaleDraw.setLength( rect.width() );
+        }
+        else
+        {
+            d_scaleDraw.move( rect.center().x(), rect.top() );
+            d_scaleDraw.setLength( rect.height() );
+        }
+    }
+
+    virtual void run( QPainter *painter )
+    {
+        // a new scale division for each run to avoid
+        // hitting the cache for the tick labels
+
+        const double from = 1.0 + ( d_count++ % 100 );
+        d_scaleDraw.setScaleDiv( d_engine->divideScale( from, 1000.0 * from, 10, 5 ) );
+
+        ( void ) d_scaleDraw.extent( painter->font() );
+        d_scaleDraw.draw( painter, QPalette() );
+    }
+
+private:
+    QwtScaleEngine *d_engine;
+    QwtScaleDraw d_scaleDraw;
+    int d_count;
+};
+
+class LegendTask: public Task
+{
+public:
+    LegendTask( QwtPlot *plot, QwtLegend *legend, const QRectF &rect ):
+        d_plot( plot ),
+        d_legend( legend ),
+        d_rect( rect )
+    {
+    }
+
+    virtual void run( QPainter *painter )
+    {
+        d_plot->updateLegend();
+        d_legend->renderLegend( painter, d_rect, true );
+    }
+
+private:
+    QwtPlot *d_plot;
+    QwtLegend *d_legend;
+    const QRectF d_rect;
+};
+
+class Benchmark
+{
+public:
+    Benchmark():
+        maxPoints( 1000000 ),
+        minTime( 500.0 ),
+        maxIterations( 50 ),
+        size( 800, 600 ),
+        d_out( stdout )
+    {
+    }
+
+    bool parseArguments( const QStringList &args )
+    {
+        for ( int i = 1; i < args.size(); i++ )
+        {
+            const QString &arg = args[i];
+            if ( i == args.size() - 1 )
+                return false;
+
+            const QString value = args[++i];
+
+            if ( arg == "--max-points" )
+            {
+                maxPoints = value.toLongLong();
+            }
+            else if ( arg == "--min-time" )
+            {
+                minTime = value.toDouble();
+            }
+            else if ( arg == "--max-iterations" )
+            {
+                maxIterations = qMax( value.toInt(), 1 );
+            }
+            else if ( arg == "--size" )
+            {
+                const QStringList wh = value.split( 'x' );
+                if ( wh.size() != 2 )
+                    return false;
+
+                size = QSize( wh[0].toInt(), wh[1].toInt() );
+            }
+            else if ( arg == "--filter" )
+            {
+                filter = QRegExp( value );
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        return size.isValid() && maxPoints > 0;
+    }
+
+    QRectF rect() const
+    {
+        return QRectF( 0.0, 0.0, size.width(), size.height() );
+    }
+
+    bool isEnabled( const QString &suite, const QString &name ) const
+    {
+        if ( filter.isEmpty() )
+            return true;
+
+        return filter.indexIn( suite + "/" + name ) >= 0;
+    }
+
+    void printHeader()
+    {
+        d_out << "# suite\tcase\tpoints\titerations\tmedian_ms\tmin_ms\tpoints_per_s\n";
+        d_out.flush();
+    }
+
+    void measure( const QString &suite, const QString &name,
+        qint64 numPoints, Task *task )
+    {
+        if ( !isEnabled( suite, name ) )
+            return;
+
+        QImage image( size, QImage::Format_ARGB32_Premultiplied );
+
+        // warming up, filling caches
+
+        runOnce( image, task );
+
+        QVector<double> times;
+
+        double total = 0.0;
+        while ( times.size() < maxIterations && total < minTime )
+        {
+            const double ms = runOnce( image, task );
+
+            times += ms;
+            total += ms;
+        }
+
+        std::sort( times.begin(), times.end() );
+
+        const double median = times[ times.size() / 2 ];
+        const double pointsPerSecond = ( median > 0.0 )
+            ? numPoints * 1000.0 / median : 0.0;
+
+        d_out << suite << '\t' << name << '\t' << numPoints << '\t'
+            << times.size() << '\t'
+            << QString::number( median, 'f', 3 ) << '\t'
+            << QString::number( times.first(), 'f', 3 ) << '\t'
+            << QString::number( pointsPerSecond, 'f', 0 ) << '\n';
+
+        d_out.flush();
+    }
+
+    qint64 maxPoints;
+    double minTime;
+    int maxIterations;
+    QSize size;
+    QRegExp filter;
+
+private:
+    double runOnce( QImage &image, Task *task ) const
+    {
+        image.fill( Qt::white );
+
+        QElapsedTimer timer;
+        timer.start();
+
+        QPainter painter( &image );
+        task->run( &painter );
+        painter.end();
+
+        return timer.nsecsElapsed() / 1e6;
+    }
+
+    QTextStream d_out;
+};
+
+static QString curveStyleName( QwtPlotCurve::CurveStyle style )
+{
+    switch( style )
+    {
+        case QwtPlotCurve::Lines:
+            return "Lines";
+        case QwtPlotCurve::Sticks:
+            return "Sticks";
+        case QwtPlotCurve::Steps:
+            return "Steps";
+        case QwtPlotCurve::Dots:
+            return "Dots";
+        default:
+            return "NoCurve";
+    }
+}
+
+static QString paintAttributesName( int attributes )
+{
+    static const char *names[] =
+    {
+        "ClipPolygons",
+        "FilterPoints",
+        "MinimizeMemory",
+        "ImageBuffer",
+        "FilterPointsAggressive",
+        "CacheFittedCurve"
+    };
+
+    QStringList list;
+    for ( int i = 0; i < 6; i++ )
+    {
+        if ( attributes & ( 1 << i ) )
+            list += names[i];
+    }
+
+    return list.isEmpty() ? QString( "None" ) : list.join( "|" );
+}
+
+static void benchmarkCurves( Benchmark &benchmark )
+{
+    const QRectF rect = benchmark.rect();
+
+    QwtScaleMap xMap;
+    xMap.setScaleInterval( 0.0, 100.0 );
+    xMap.setPaintInterval( rect.left(), rect.right() );
+
+    QwtScaleMap yMap;
+    yMap.setScaleInterval( -1.1, 1.1 );
+    yMap.setPaintInterval( rect.bottom(), rect.top() );
+
+    const QwtPlotCurve::CurveStyle styles[] =
+    {
+        QwtPlotCurve::Lines,
+        QwtPlotCurve::Sticks,
+        QwtPlotCurve::Steps,
+        QwtPlotCurve::Dots
+    };
+
+    for ( qint64 numPoints = 1000;
+        numPoints <= benchmark.maxPoints; numPoints *= 10 )
+    {
+        QwtPlotCurve curve;
+        curve.setData( new SineData( numPoints ) );
+        curve.setCurveFitter( new QwtWeedingCurveFitter( 1.0 ) );
+
+        // the last case are fitted lines, where
+        // CacheFittedCurve has an effect
+
+        for ( int i = 0; i <= 4; i++ )
+        {
+            const bool fitted = ( i == 4 );
+
+            curve.setStyle( fitted ? QwtPlotCurve::Lines : styles[i] );
+            curve.setCurveAttribute( QwtPlotCurve::Fitted, fitted );
+
+            for ( int attributes = 0; attributes < 64; attributes++ )
+            {
+                for ( int bit = 0; bit < 6; bit++ )
+                {
+                    const QwtPlotCurve::PaintAttribute attribute =
+                        static_cast<QwtPlotCurve::PaintAttribute>( 1 << bit );
+
+                    curve.setPaintAttribute( attribute, attributes & attribute );
+                }
+
+                const QString name = QString( "%1/%2/%3" )
+                    .arg( fitted ? QString( "Fitted" ) : curveStyleName( styles[i] ) )
+                    .arg( paintAttributesName( attributes ) )
+                    .arg( numPoints );
+
+                ItemTask task( &curve, xMap, yMap, rect );
+                benchmark.measure( "curve", name, numPoints, &task );
+            }
+        }
+    }
+}
+
+static void benchmarkSpectrogram( Benchmark &benchmark )
+{
+    const QRectF rect = benchmark.rect();
+
+    QwtScaleMap xMap;
+    xMap.setScaleInterval( 0.0, 1.0 );
+    xMap.setPaintInterval( rect.left(), rect.right() );
+
+    QwtScaleMap yMap;
+    yMap.setScaleInterval( 0.0, 1.0 );
+    yMap.setPaintInterval( rect.bottom(), rect.top() );
+
+    const qint64 numPixels = qint64( rect.width() ) * qint64( rect.height() );
+
+    const int matrixSizes[] = { 100, 1000 };
+
+    for ( int s = 0; s < 2; s++ )
+    {
+        const int n = matrixSizes[s];
+
+        QVector<double> values( n * n );
+        for ( int row = 0; row < n; row++ )
+        {
+            for ( int col = 0; col < n; col++ )
+                values[ row * n + col ] = qSin( 0.1 * row ) * qCos( 0.07 * col );
+        }
+
+        for ( int mode = 0; mode < 2; mode++ )
+        {
+            for ( int format = 0; format < 2; format++ )
+            {
+                QwtMatrixRasterData *data = new QwtMatrixRasterData();
+                data->setInterval( Qt::XAxis, QwtInterval( 0.0, 1.0 ) );
+                data->setInterval( Qt::YAxis, QwtInterval( 0.0, 1.0 ) );
+                data->setInterval( Qt::ZAxis, QwtInterval( -1.0, 1.0 ) );
+                data->setValueMatrix( values, n );
+                data->setResampleMode(
+                    static_cast<QwtMatrixRasterData::ResampleMode>( mode ) );
+
+                const QwtColorMap::Format colorFormat = ( format == 0 )
+                    ? QwtColorMap::RGB : QwtColorMap::Indexed;
+
+                QwtPlotSpectrogram spectrogram;
+                spectrogram.setData( data );
+                spectrogram.setColorMap(
+                    new QwtLinearColorMap( Qt::darkCyan, Qt::red, colorFormat ) );
+
+                const QString name = QString( "%1/%2/%3x%3" )
+                    .arg( mode == 0 ? "NearestNeighbour" : "BilinearInterpolation" )
+                    .arg( format == 0 ? "RGB" : "Indexed" )
+                    .arg( n );
+
+                ItemTask task( &spectrogram, xMap, yMap, rect );
+                benchmark.measure( "spectrogram", name, numPixels, &task );
+            }
+        }
+    }
+}
+
+static QString symbolStyleName( QwtSymbol::Style style )
+{
+    switch( style )
+    {
+        case QwtSymbol::Ellipse:
+            return "Ellipse";
+        case QwtSymbol::Rect:
+            return "Rect";
+        case QwtSymbol::Diamond:
+            return "Diamond";
+        case QwtSymbol::Triangle:
+            return "Triangle";
+        case QwtSymbol::Cross:
+            return "Cross";
+        case QwtSymbol::XCross:
+            return "XCross";
+        case QwtSymbol::HLine:
+            return "HLine";
+        case QwtSymbol::VLine:
+            return "VLine";
+        case QwtSymbol::Star1:
+            return "Star1";
+        case QwtSymbol::Star2:
+            return "Star2";
+        case QwtSymbol::Hexagon:
+            return "Hexagon";
+        default:
+            return QString::number( style );
+    }
+}
+
+static void benchmarkSymbols( Benchmark &benchmark )
+{
+    const QRectF rect = benchmark.rect();
+
+    const QwtSymbol::Style styles[] =
+    {
+        QwtSymbol::Ellipse,
+        QwtSymbol::Rect,
+        QwtSymbol::Diamond,
+        QwtSymbol::Triangle,
+        QwtSymbol::Cross,
+        QwtSymbol::XCross,
+        QwtSymbol::HLine,
+        QwtSymbol::VLine,
+        QwtSymbol::Star1,
+        QwtSymbol::Star2,
+        QwtSymbol::Hexagon
+    };
+    const int numStyles = sizeof( styles ) / sizeof( styles[0] );
+
+    for ( int numPoints = 1000; numPoints <= 100000; numPoints *= 10 )
+    {
+        QPolygonF points( numPoints );
+        for ( int i = 0; i < numPoints; i++ )
+        {
+            const double x = rect.left() + ( i % 997 ) * rect.width() / 997;
+            const double y = rect.top() + ( i % 991 ) * rect.height() / 991;
+
+            points[i] = QPointF( x, y );
+        }
+
+        for ( int i = 0; i < numStyles; i++ )
+        {
+            for ( int cache = 0; cache < 2; cache++ )
+            {
+                QwtSymbol symbol( styles[i], QBrush( Qt::yellow ),
+                    QPen( Qt::darkBlue ), QSize( 8, 8 ) );
+
+                symbol.setCachePolicy( cache == 0
+                    ? QwtSymbol::NoCache : QwtSymbol::AutoCache );
+
+                const QString name = QString( "%1/%2/%3" )
+                    .arg( symbolStyleName( styles[i] ) )
+                    .arg( cache == 0 ? "NoCache" : "AutoCache" )
+                    .arg( numPoints );
+
+                SymbolTask task( &symbol, points );
+                benchmark.measure( "symbol", name, numPoints, &task );
+            }
+        }
+    }
+}
+
+static void benchmarkFitters( Benchmark &benchmark )
+{
+    const QRectF rect = benchmark.rect();
+
+    for ( qint64 numPoints = 1000;
+        numPoints <= benchmark.maxPoints; numPoints *= 10 )
+    {
+        // a noisy signal in paint device coordinates
+
+        QPolygonF points( numPoints );
+        for ( int i = 0; i < numPoints; i++ )
+        {
+            const double x = rect.left() + rect.width() * i / numPoints;
+            const double y = rect.center().y()
+                + 0.4 * rect.height() * qSin( 0.05 * x )
+                + ( ( i * 37 ) % 100 ) * 0.02;
+
+            points[i] = QPointF( x, y );
+        }
+
+        QwtWeedingCurveFitter weeding( 1.0 );
+
+        {
+            FitterTask task( &weeding, points );
+            benchmark.measure( "fitter",
+                QString( "Weeding/Serial/%1" ).arg( numPoints ), numPoints, &task );
+        }
+
+        {
+            weeding.setChunkSize( 10000 );
+
+            FitterTask task( &weeding, points );
+            benchmark.measure( "fitter",
+                QString( "Weeding/Chunked/%1" ).arg( numPoints ), numPoints, &task );
+
+            weeding.setChunkSize( 0 );
+        }
+
+        {
+            weeding.setNumThreads( 0 );
+
+            FitterTask task( &weeding, points );
+            benchmark.measure( "fitter",
+                QString( "Weeding/Parallel/%1" ).arg( numPoints ), numPoints, &task );
+        }
+
+        {
+            QwtStreamingCurveFitter streaming( 1.0 );
+
+            FitterTask task( &streaming, points );
+            benchmark.measure( "fitter",
+                QString( "Streaming/%1" ).arg( numPoints ), numPoints, &task );
+        }
+    }
+}
+
+static void benchmarkScales( Benchmark &benchmark )
+{
+    const QRectF rect = benchmark.rect().adjusted( 50, 50, -50, -50 );
+
+    const QwtScaleDraw::Alignment alignments[] =
+    {
+        QwtScaleDraw::BottomScale,
+        QwtScaleDraw::TopScale,
+        QwtScaleDraw::LeftScale,
+        QwtScaleDraw::RightScale
+    };
+
+    const char *alignmentNames[] =
+    {
+        "Bottom", "Top", "Left", "Right"
+    };
+
+    for ( int engineType = 0; engineType < 2; engineType++ )
+    {
+        QwtScaleEngine *engine;
+        if ( engineType == 0 )
+            engine = new QwtLinearScaleEngine();
+        else
+            engine = new QwtLogScaleEngine();
+
+        for ( int i = 0; i < 4; i++ )
+        {
+            const QString name = QString( "%1/%2" )
+                .arg( engineType == 0 ? "Linear" : "Log" )
+                .arg( alignmentNames[i] );
+
+            ScaleTask task( engine, alignments[i], rect );
+            benchmark.measure( "scale", name, 1, &task );
+        }
+
+        delete engine;
+    }
+}
+
+static void benchmarkLegend( Benchmark &benchmark )
+{
+    const QRectF rect = benchmark.rect();
+
+    for ( int numItems = 10; numItems <= 100; numItems *= 10 )
+    {
+        QwtPlot plot;
+
+        QwtLegend *legend = new QwtLegend();
+        legend->setMaxColumns( 4 );
+        plot.insertLegend( legend );
+
+        for ( int i = 0; i < numItems; i++ )
+        {
+            QwtPlotCurve *curve = new QwtPlotCurve( QString( "Curve %1" ).arg( i ) );
+            curve->setPen( QColor::fromHsv( ( i * 37 ) % 360, 255, 200 ) );
+            curve->setLegendAttribute( QwtPlotCurve::LegendShowLine, true );
+            curve->attach( &plot );
+        }
+
+        LegendTask task( &plot, legend, rect );
+        benchmark.measure( "legend", QString::number( numItems ), numItems, &task );
+    }
+}
+
+int main( int argc, char **argv )
+{
+#if QT_VERSION >= 0x050000
+    if ( qgetenv( "QT_QPA_PLATFORM" ).isEmpty() )
+        qputenv( "QT_QPA_PLATFORM", "offscreen" );
+#endif
+
+    QApplication app( argc, argv );
+
+    Benchmark benchmark;
+    if ( !benchmark.parseArguments( app.arguments() ) )
+    {
+        qWarning( "Usage: plotprof [--max-points n] [--min-time ms] "
+            "[--max-iterations n] [--size wxh] [--filter regexp]" );
+        return -1;
+    }
+
+    benchmark.printHeader();
+
+    benchmarkCurves( benchmark );
+    benchmarkSpectrogram( benchmark );
+    benchmarkSymbols( benchmark );
+    benchmarkFitters( benchmark );
+    benchmarkScales( benchmark );
+    benchmarkLegend( benchmark );
+
+    return 0;
+}
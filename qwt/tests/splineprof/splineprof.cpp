@@ -13,6 +13,23 @@ void testSpline( const char *name, QwtSplineInterpolating *spline,
 	timer.start();
 	const QVector<QLineF> lines = spline->bezierControlLines( points );
 	qDebug() << name << ":" << timer.elapsed();
+
+	if ( type == QwtSplineParametrization::ParameterX )
+	{
+		timer.start();
+		const QPolygonF polygon = spline->equidistantPolygon( points, 0.5, false );
+		qDebug() << name << "equidistant:" << timer.elapsed();
+
+		QVector<double> xValues( points.size() );
+		for ( int i = 0; i < xValues.size(); i++ )
+			xValues[i] = i + 0.5;
+
+		QVector<double> slopes;
+
+		timer.start();
+		const QVector<double> values = spline->valuesAt( points, xValues, &slopes );
+		qDebug() << name << "resampled:" << timer.elapsed();
+	}
 }
 
 void testSplines( int paramType, const QPolygonF &points )
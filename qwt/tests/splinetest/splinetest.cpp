@@ -1,7 +1,12 @@
 #include <qwt_spline_cubic.h>
 #include <qwt_spline_local.h>
+#include <qwt_spline_local_incremental.h>
 #include <qwt_spline_parametrization.h>
+#include <qwt_spline_polynomial.h>
+#include <qwt_streaming_curve_fitter.h>
 #include <qpolygon.h>
+#include <qline.h>
+#include <qnumeric.h>
 #include <qdebug.h>
 
 #define DEBUG_ERRORS 1
@@ -578,8 +583,229 @@ void testDuplicates()
     testPaths( "Last point twice", spline, points, points4 );
 }
 
+static inline bool nearlyEqual( double a, double b )
+{
+    // values calculated in different ways
+    const double eps = 1e-8;
+    return qAbs( a - b ) <= eps * qMax( 1.0, qMax( qAbs( a ), qAbs( b ) ) );
+}
+
+static QPolygonF testPoints()
+{
+    QPolygonF points;
+    points << QPointF( 10, 50 ) << QPointF( 20, 90 ) << QPointF( 25, 60 )
+        << QPointF( 35, 38 ) << QPointF( 42, 40 ) << QPointF( 55, 60 )
+        << QPointF( 60, 50 ) << QPointF( 65, 80 ) << QPointF( 73, 30 )
+        << QPointF( 82, 30 ) << QPointF( 87, 40 ) << QPointF( 95, 50 );
+
+    return points;
+}
+
+void testIncremental( QwtSplineLocal::Type type, const char *name )
+{
+    const QPolygonF points = testPoints();
+
+    const QwtSplineLocal spline( type );
+
+    const QVector<double> m = spline.slopes( points );
+    const QVector<QLineF> lines = spline.bezierControlLines( points );
+
+    // appending the points in chunks of different sizes
+
+    QwtSplineLocalIncremental incremental( type );
+    incremental.setPoints( points.mid( 0, 2 ) );
+
+    int from = 2;
+    for ( int chunkSize = 1; from < points.size(); chunkSize++ )
+    {
+        incremental.appendPoints( points.mid( from, chunkSize ) );
+        from += chunkSize;
+    }
+
+    const QVector<double> mi = incremental.slopes();
+    const QVector<QLineF> linesi = incremental.bezierControlLines();
+
+    int numErrors = 0;
+
+    if ( mi.size() != m.size() || linesi.size() != lines.size() )
+    {
+        numErrors++;
+    }
+    else
+    {
+        for ( int i = 0; i < m.size(); i++ )
+        {
+            if ( !nearlyEqual( m[i], mi[i] ) )
+                numErrors++;
+        }
+
+        for ( int i = 0; i < lines.size(); i++ )
+        {
+            if ( !nearlyEqual( lines[i].x1(), linesi[i].x1() )
+                || !nearlyEqual( lines[i].y1(), linesi[i].y1() )
+                || !nearlyEqual( lines[i].x2(), linesi[i].x2() )
+                || !nearlyEqual( lines[i].y2(), linesi[i].y2() ) )
+            {
+                numErrors++;
+            }
+        }
+    }
+
+    if ( numErrors > 0 )
+    {
+        qDebug() << "Incremental Spline" << name << ":" << false;
+
+#if DEBUG_ERRORS > 0
+        qDebug() << "  different from a full recalculation" << numErrors;
+#endif
+    }
+}
+
+void testIncremental()
+{
+    testIncremental( QwtSplineLocal::Cardinal, "Cardinal" );
+    testIncremental( QwtSplineLocal::ParabolicBlending, "ParabolicBlending" );
+    testIncremental( QwtSplineLocal::Akima, "Akima" );
+    testIncremental( QwtSplineLocal::PChip, "PChip" );
+}
+
+void testValuesAt( const QwtSplineC1 &spline, const char *name )
+{
+    const QPolygonF points = testPoints();
+
+    const QVector<QwtSplinePolynomial> polynomials =
+        spline.polynomials( points );
+
+    // some values in each interval, including the control points
+
+    QVector<double> xValues;
+    for ( int i = 0; i < points.size() - 1; i++ )
+    {
+        const double x1 = points[i].x();
+        const double dx = points[i + 1].x() - x1;
+
+        for ( int j = 0; j < 4; j++ )
+            xValues += x1 + j * 0.25 * dx;
+    }
+    xValues += points.last().x();
+
+    QVector<double> slopes;
+    QVector<double> curvatures;
+
+    const QVector<double> values =
+        spline.valuesAt( points, xValues, &slopes, &curvatures );
+
+    int numErrors = 0;
+
+    if ( values.size() != xValues.size() )
+    {
+        numErrors++;
+    }
+    else
+    {
+        int index = 0;
+        for ( int i = 0; i < xValues.size(); i++ )
+        {
+            // the last point belongs to the last polynomial
+            while ( index < polynomials.size() - 1
+                && xValues[i] >= points[index + 1].x() )
+            {
+                index++;
+            }
+
+            const QwtSplinePolynomial &polynomial = polynomials[index];
+            const double x = xValues[i] - points[index].x();
+
+            if ( !nearlyEqual( values[i],
+                    points[index].y() + polynomial.valueAt( x ) )
+                || !nearlyEqual( slopes[i], polynomial.slopeAt( x ) )
+                || !nearlyEqual( curvatures[i], polynomial.curvatureAt( x ) ) )
+            {
+#if DEBUG_ERRORS > 1
+                qDebug() << "invalid value" << xValues[i] << values[i]
+                    << points[index].y() + polynomial.valueAt( x );
+#endif
+                numErrors++;
+            }
+        }
+    }
+
+    if ( numErrors > 0 )
+    {
+        qDebug() << "Values of Spline" << name << ":" << false;
+
+#if DEBUG_ERRORS > 0
+        qDebug() << "  different from the polynomials" << numErrors;
+#endif
+    }
+}
+
+void testValuesAt()
+{
+    const QwtSplineLocal cardinal( QwtSplineLocal::Cardinal );
+    testValuesAt( cardinal, "Cardinal" );
+
+    const QwtSplineLocal parabolicBlending( QwtSplineLocal::ParabolicBlending );
+    testValuesAt( parabolicBlending, "ParabolicBlending" );
+
+    const QwtSplineLocal akima( QwtSplineLocal::Akima );
+    testValuesAt( akima, "Akima" );
+
+    const QwtSplineLocal pchip( QwtSplineLocal::PChip );
+    testValuesAt( pchip, "PChip" );
+
+    const QwtSplineCubic cubic;
+    testValuesAt( cubic, "Cubic" );
+}
+
+void testStreamingFitter( const QList<int> &invalid, const char *name )
+{
+    // with a tolerance of 0 no point of a zigzag line can be removed
+
+    QPolygonF points;
+    for ( int i = 0; i < 20; i++ )
+        points += QPointF( i, ( i % 2 ) ? 10.0 : 20.0 + i );
+
+    for ( int i = 0; i < invalid.size(); i++ )
+        points[ invalid[i] ].setY( qQNaN() );
+
+    QPolygonF expected;
+    for ( int i = 0; i < points.size(); i++ )
+    {
+        if ( !qIsNaN( points[i].y() ) )
+            expected += points[i];
+    }
+
+    QwtStreamingCurveFitter fitter;
+    fitter.setTolerance( 0.0 );
+    fitter.setChunkSize( 5 );
+
+    const QPolygonF fitted = fitter.fitCurve( points );
+    if ( fitted != expected )
+    {
+        qDebug() << "Streaming Fitter" << name << ":" << false;
+
+#if DEBUG_ERRORS > 0
+        qDebug() << "  " << fitted.size() << "points instead of" << expected.size();
+#endif
+    }
+}
+
+void testStreamingFitter()
+{
+    // chunks of 5 points are sharing the points 4, 8, 12 and 16
+
+    testStreamingFitter( QList<int>(), "No gaps" );
+    testStreamingFitter( QList<int>() << 4, "Gap at a border" );
+    testStreamingFitter( QList<int>() << 8 << 9 << 12, "Gaps at borders" );
+    testStreamingFitter( QList<int>() << 4 << 5 << 6 << 7 << 8, "Invalid chunk" );
+}
+
 int main()
 {
     testSplines();
     testDuplicates();
+    testIncremental();
+    testValuesAt();
+    testStreamingFitter();
 }
@@ -14,3 +14,9 @@ TEMPLATE = subdirs
 SUBDIRS += \
     splinetest \
     splineprof
+
+contains(QWT_CONFIG, QwtPlot) {
+
+    SUBDIRS += \
+        plotprof
+}